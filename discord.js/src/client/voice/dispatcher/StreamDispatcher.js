@@ -32,7 +32,7 @@ const nonce = Buffer.alloc(24);
 class StreamDispatcher extends Writable {
   constructor(
     player,
-    { seek = 0, volume = 1, fec, plp, bitrate = 96, highWaterMark = 12, live = false } = {},
+    { seek = 0, volume = 1, fec, plp, bitrate = 96, highWaterMark = 12, live = false, rtp = false } = {},
     streams,
   ) {
     const streamOptions = { seek, volume, fec, plp, bitrate, highWaterMark };
@@ -49,6 +49,12 @@ class StreamDispatcher extends Writable {
      */
     this.live = live;
 
+    /**
+     * If the chunks written to this dispatcher are complete RTP packets that only need encrypting
+     * @type {boolean}
+     */
+    this.rtp = rtp;
+
     this.streamOptions = streamOptions;
     this.streams = streams;
     this.streams.silence = new Silence();
@@ -261,6 +267,10 @@ class StreamDispatcher extends Writable {
 
   _playChunk(chunk) {
     if (this.player.dispatcher !== this || !this.player.voiceConnection.authentication.secret_key) return;
+    if (this.rtp) {
+      this._sendPacket(this._createRtpPacket(chunk));
+      return;
+    }
     this._sendPacket(this._createPacket(this._sdata.sequence, this._sdata.timestamp, chunk));
   }
 
@@ -292,6 +302,12 @@ class StreamDispatcher extends Writable {
     return Buffer.concat([packetBuffer, ...this._encrypt(buffer)]);
   }
 
+  _createRtpPacket(chunk) {
+    const packetBuffer = chunk.slice(0, 12);
+    packetBuffer.copy(nonce, 0, 0, 12);
+    return Buffer.concat([packetBuffer, ...this._encrypt(chunk.slice(12))]);
+  }
+
   _sendPacket(packet) {
     /**
      * Emitted whenever the dispatcher has debug information.
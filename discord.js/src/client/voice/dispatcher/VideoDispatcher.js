@@ -38,6 +38,7 @@ class VideoDispatcher extends Writable {
     this._nonceBuffer = Buffer.alloc(24);
 
     this._cachedIFrame = Buffer.alloc(0);
+    this._iFrameFragments = null;
 
     this.streamingData = {
       sequence: 1583,
@@ -102,13 +103,55 @@ class VideoDispatcher extends Writable {
     done();
   }
 
-  _writeNal(nal, now, last = false) {
+  _rtpTimestamp(now) {
     if (!this.hrStartTime) {
       this.hrStartTime = now;
     }
 
     const timeDelta = now - this.hrStartTime;
-    const timestamp = Number(BigInt.asUintN(32, timeDelta / RTP_PERIOD));
+    return Number(BigInt.asUintN(32, timeDelta / RTP_PERIOD));
+  }
+
+  /**
+   * Sends an RTP payload that was already packetized, e.g. a single NAL unit or FU-A fragment.
+   * @param {Buffer} payload The RTP payload
+   * @param {bigint} now The high resolution time the frame was received at
+   * @param {boolean} marker Whether the payload ends the frame
+   * @private
+   */
+  _writePayload(payload, now, marker) {
+    this._cachePayload(payload);
+    this._sendPacket(this._createPacket(this.streamingData.sequence, this._rtpTimestamp(now), payload, marker));
+  }
+
+  /**
+   * Keeps the last IDR NAL unit of a packetized stream for late joiners, like _writeNal does for raw streams.
+   * IDR NAL units split into FU-A fragments are put back together.
+   * @param {Buffer} payload The RTP payload
+   * @private
+   */
+  _cachePayload(payload) {
+    const payloadType = payload[0] & 0b00011111;
+
+    if (payloadType === 5) {
+      this._cachedIFrame = payload;
+    } else if (payloadType === 28 && (payload[1] & 0b00011111) === 5) {
+      if (payload[1] & 0b10000000) {
+        const header = Buffer.from([(payload[0] & 0b11100000) | 5]);
+        this._iFrameFragments = [header];
+      }
+      if (!this._iFrameFragments) return;
+
+      this._iFrameFragments.push(payload.slice(2));
+      if (payload[1] & 0b01000000) {
+        this._cachedIFrame = Buffer.concat(this._iFrameFragments);
+        this._iFrameFragments = null;
+      }
+    }
+  }
+
+  _writeNal(nal, now, last = false) {
+    const timestamp = this._rtpTimestamp(now);
     const prio = (nal[0] & 0b01100000) >> 5;
     const nalType = nal[0] & 0b00011111
 
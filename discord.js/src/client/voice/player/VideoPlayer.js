@@ -345,7 +345,12 @@ class VideoPlayer extends EventEmitter {
     };
   }
 
-  async playRawVideo(videoStream, audioStream, { volume = 1.0 } = {}) {
+  async playRawVideo(videoStream, audioStream, { volume = 1.0, packetized = false, rtpAudio = false } = {}) {
+    // Packetized streams carry H.264 RTP payloads, they can't be sent as another codec
+    if (packetized && this.voiceConnection.videoCodec !== 'H264') {
+      throw new Error(`Packetized video requires H264, the connection uses ${this.voiceConnection.videoCodec}`);
+    }
+
     await this.voiceConnection.resetVideoContext();
 
     this.dispatcher = this.createDispatcher();
@@ -356,7 +361,15 @@ class VideoPlayer extends EventEmitter {
 
       const now = process.hrtime.bigint();
 
-      if (this.voiceConnection.videoCodec === 'H264') {
+      if (packetized) {
+        // Each chunk holds the RTP payloads of one frame, prefixed with their 16 bit length
+        let offset = 0;
+        while (offset + 2 <= data.length) {
+          const end = offset + 2 + data.readUInt16BE(offset);
+          this.dispatcher._writePayload(data.slice(offset + 2, end), now, end >= data.length);
+          offset = end;
+        }
+      } else if (this.voiceConnection.videoCodec === 'H264') {
         let nextNal = 4;
         // eslint-disable-next-line no-constant-condition
         while (true) {
@@ -380,9 +393,11 @@ class VideoPlayer extends EventEmitter {
       }
     });
 
+    // Audio that is already framed as RTP can't go through the volume transformer
+    const audioOptions = rtpAudio ? { type: 'opus', volume: false, rtp: true } : { type: 'opus', volume };
     return {
       video: this.dispatcher,
-      audio: this.voiceConnection.play(audioStream, { type: 'opus', volume }),
+      audio: this.voiceConnection.play(audioStream, audioOptions),
     };
   }
 
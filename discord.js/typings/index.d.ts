@@ -1662,7 +1662,7 @@ declare module 'discord.js' {
       video: VideoDispatcher,
       audio: StreamDispatcher
     };
-    public playRawVideo(videoStream: Readable, ideoStream: Readable, options?: { volume: number }): {
+    public playRawVideo(videoStream: Readable, ideoStream: Readable, options?: { volume?: number | false; packetized?: boolean; rtpAudio?: boolean }): {
       video: VideoDispatcher
       audio: StreamDispatcher
     };
@@ -3308,6 +3308,7 @@ declare module 'discord.js' {
     bitrate?: number | string;
     highWaterMark?: number;
     live?: boolean;
+    rtp?: boolean;
     useNvenc?: boolean;
     useVaapi?: boolean;
     rtBufferSize?: string;
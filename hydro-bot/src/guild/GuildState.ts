@@ -8,11 +8,59 @@ import {MediaResult} from "../downloader/Downloader";
 import {StreamDispatcher, TextChannel, User, VoiceChannel, VoiceConnection} from "discord.js";
 import path from "path";
 import debugBase from "debug";
-import {AudioEncoder, Scene, Source, SceneItem, StreamOutput, Studio, VideoEncoder} from 'obs-node'
+import {AudioEncoder, MediaPlayer, ObsData, Scene, Source, SourcePool, StreamOutput, Studio, VideoEncoder, View} from 'obs-node'
 
 const webUiPath = require.resolve("web-ui/build/index.html")
 const debugVideo = debugBase('hydro-bot:video')
 
+// The web UI takes seconds to start, keep one loaded between voice sessions.
+const browserSettings = {
+  is_local_file: true,
+  local_file: webUiPath,
+  fps: 60,
+  width: 1920,
+  height: 1080
+}
+SourcePool.configure({minIdle: 1, maxIdle: 4, idleTimeout: 10 * 60 * 1000})
+
+// Video can only be reset while no guild is encoding, every guild renders
+// its own view of the main mix instead.
+let studioReset = false
+
+function resetStudio() {
+  if (studioReset) return
+
+  Studio.resetVideo({
+    baseWidth: 1920,
+    baseHeight: 1080,
+    outputWidth: 1920,
+    outputHeight: 1080,
+    fps: 60,
+  })
+
+  Studio.resetAudio({
+    sampleRate: 48000,
+    speakers: 1,
+  })
+  studioReset = true
+}
+
+// Views only draw their scenes. Sources are active and heard only while
+// shown on an output channel, so every playing guild puts its scene on a
+// channel of its own and mixes its audio into a track of its own, the one
+// its audio encoder reads. libobs has six tracks.
+const AUDIO_MIXES = 6
+const usedMixes = new Set<number>()
+
+function acquireMix(): number {
+  for (let mix = 0; mix < AUDIO_MIXES; mix++) {
+    if (usedMixes.has(mix)) continue
+    usedMixes.add(mix)
+    return mix
+  }
+  throw new Error("Too many guilds are playing at once")
+}
+
 export type QueuedMedia = MediaResult & {requester: User}
 
 interface Playing {
@@ -28,8 +76,12 @@ interface VoiceState {
   logChannel: TextChannel
   audioDispatcher: StreamDispatcher
   output: StreamOutput
+  player: MediaPlayer
+  preloaded: QueuedMedia | null
   videoScene: Scene
-  sceneItems: { [name: string]: SceneItem}
+  view: View
+  // Output channel and audio track of the guild.
+  mix: number
   sources: { [name: string]: Source}
 }
 
@@ -63,104 +115,134 @@ export default class GuildState {
     if (!videoClientChannel) throw new Error("Video client cannot access channel")
     if (!(videoClientChannel instanceof VoiceChannel)) throw new Error("Channel is not a voice channel")
 
-    const voiceConnection  = await videoClientChannel.join(true)
+    resetStudio()
+    const mix = acquireMix()
+
+    // Everything created so far is released again if joining fails.
+    let voiceConnection: VoiceConnection | undefined
+    let player: MediaPlayer | undefined
+    let browser: Source | undefined
+    let videoScene: Scene | undefined
+    let view: View | undefined
+    let output: StreamOutput | undefined
+
+    try {
+      voiceConnection = await videoClientChannel.join(true)
+
+      // The next track is opened while the current one plays, and both slots
+      // switch to it on the frame the video of the current one ends.
+      player = new MediaPlayer("Media", [
+        {hw_decode: true, is_local_file: false, seekable: true},
+        {hw_decode: false, is_local_file: false, seekable: true},
+      ], {
+        mixers: 1 << mix,
+        onSwap: (preloaded) => {
+          this.onMediaSwap(preloaded).catch((e: Error) => {
+            logger.error(`Error advancing queue for guild ${this.id}:`)
+            logger.error(util.inspect(e))
+          })
+        },
+      })
 
-    Studio.resetVideo({
-      baseWidth: 1920,
-      baseHeight: 1080,
-      outputWidth: 1920,
-      outputHeight: 1080,
-      fps: 60,
-    })
+      browser = SourcePool.acquire("browser_source", "Browser", browserSettings)
+      const sources = {
+        video: player.getSource(0),
+        audio: player.getSource(1),
+        browser,
+      }
 
-    Studio.resetAudio({
-      sampleRate: 48000,
-      speakers: 1,
-    })
+      videoScene = new Scene("Video Scene")
 
-    const sources = {
-      video: new Source("ffmpeg_source", "Video", {
-        close_when_inactive: false,
-        restart_on_activate: false,
-        hw_decode: true,
-        input: "",
-        is_local_file: false,
-        seekable: true
-      }),
-      audio: new Source("ffmpeg_source", "Audio", {
-        close_when_inactive: false,
-        restart_on_activate: false,
-        hw_decode: false,
-        input: "",
-        is_local_file: false,
-        seekable: true
-      }),
-      browser: new Source("browser_source", "Browser", {
-        is_local_file: true,
-        local_file: webUiPath,
-        fps: 60,
-        width: 1920,
-        height: 1080
-      }),
-    }
+      const videoItem = videoScene.addSource(sources.video)
+      videoScene.addSource(sources.browser)
+      videoScene.addSource(sources.audio)
 
-    const videoScene = new Scene("Video Scene")
+      view = new View(`Video ${this.id}`, {width: 1920, height: 1080})
+      view.setSource(0, videoScene)
 
-    const sceneItems = {
-      video: videoScene.addSource(sources.video),
-      browser: videoScene.addSource(sources.browser),
-      audio: videoScene.addSource(sources.audio),
-    }
-    videoScene.assignOutputChannel(0)
+      videoScene.setAudioMixers(1 << mix)
+      sources.browser.setAudioMixers(1 << mix)
+      videoScene.assignOutputChannel(mix)
 
-    const audioEncoder = new AudioEncoder("ffmpeg_opus", "Opus Encoder", 0, {
-      bitrate: 64,
-    })
+      const audioEncoder = new AudioEncoder("ffmpeg_opus", "Opus Encoder", mix, {
+        bitrate: 64,
+      })
 
-    const videoEncoder = new VideoEncoder("obs_x264", "x264 Encoder",  {
-      profile: "baseline",
-      rate_control: "CRF",
-      crf: 25,
-    })
+      const videoEncoder = new VideoEncoder("obs_x264", "x264 Encoder",  {
+        profile: "baseline",
+        rate_control: "CRF",
+        crf: 25,
+      })
 
-    // const videoEncoder = new VideoEncoder("ffmpeg_nvenc", "NVENC Encoder",  {
-    //   profile: "baseline",
-    //   preset: "default",
-    //   rate_control: "CQP",
-    //   cqp: 25,
-    //   bf: -1,
-    // })
-
-    const output = new StreamOutput("stream output")
-
-    const {audio: audioDispatcher} = await voiceConnection.playRawVideo(output.videoStream, output.audioStream, {volume: this.config.volume})
-
-    output.setAudioEncoder(audioEncoder)
-    output.setVideoEncoder(videoEncoder)
-    output.start()
-
-    debugVideo(`obs started for guild ${this.id}`)
-
-    this.voiceState = {
-      audioDispatcher,
-      voiceConnection,
-      voiceChannel,
-      logChannel,
-      queue: [],
-      playing: null,
-      output,
-      videoScene,
-      sceneItems,
-      sources
-    }
+      // const videoEncoder = new VideoEncoder("ffmpeg_nvenc", "NVENC Encoder",  {
+      //   profile: "baseline",
+      //   preset: "default",
+      //   rate_control: "CQP",
+      //   cqp: 25,
+      //   bf: -1,
+      // })
+
+      // Roughly two seconds of audio and video, a stalled voice connection skips
+      // to the next keyframe rather than stalling OBS.
+      output = new StreamOutput("stream output", {
+        backpressure: {capacity: 256, policy: "dropUntilKeyframe"},
+        rtp: {mtu: 1330},
+      })
 
-    this.voiceState.sceneItems.video.setTransformInfo({
-      ...this.voiceState.sceneItems.video.getTransformInfo(),
-      boundsX: 1920,
-      boundsY: 1080,
-      boundsAlignment: 0,
-      boundsType: 2,
-    })
+      // Volume is applied by the OBS mixer, so the Opus stream is passed through
+      // instead of being decoded and re-encoded to scale it.
+      sources.video.setVolume(this.config.volume)
+      sources.audio.setVolume(this.config.volume)
+
+      const {audio: audioDispatcher} = await voiceConnection.playRawVideo(output.videoStream, output.audioStream, {
+        volume: false,
+        packetized: true,
+      })
+
+      output.setMixer(mix)
+      output.setAudioEncoder(audioEncoder)
+      view.bindEncoder(videoEncoder)
+      output.setVideoEncoder(videoEncoder)
+      output.start()
+
+      debugVideo(`obs started for guild ${this.id}`)
+
+      videoScene.begin()
+          .setTransform(videoItem, {
+            ...videoItem.getTransformInfo(),
+            boundsX: 1920,
+            boundsY: 1080,
+            boundsAlignment: 0,
+            boundsType: 2,
+          })
+          .commit()
+
+      this.voiceState = {
+        audioDispatcher,
+        voiceConnection,
+        voiceChannel,
+        logChannel,
+        queue: [],
+        playing: null,
+        output,
+        player,
+        preloaded: null,
+        videoScene,
+        view,
+        mix,
+        sources
+      }
+    } catch (e) {
+      output?.release()
+      view?.release()
+      Studio.clearOutputChannel(mix)
+      usedMixes.delete(mix)
+      videoScene?.removeAll()
+      voiceConnection?.disconnect()
+      player?.release()
+      if (browser) SourcePool.release(browser)
+      throw e
+    }
 
     await logChannel.send(this.bot.embedFactory.info(
         `Joined voice channel: [${voiceChannel.id}] on guild [${voiceChannel.guild.name}]`
@@ -174,20 +256,9 @@ export default class GuildState {
       await this.voiceState.logChannel.send(this.bot.embedFactory.info(
           'Queue has been emptied. Queue something else with $play!'
       ))
-      this.voiceState.sources.video.updateSettings({
-        close_when_inactive: true,
-        hw_decode: false,
-        input: "",
-        is_local_file: false,
-        seekable: true
-      })
-      this.voiceState.sources.audio.updateSettings({
-        close_when_inactive: true,
-        hw_decode: false,
-        input: "",
-        is_local_file: false,
-        seekable: true
-      })
+      this.voiceState.player.stop()
+      this.voiceState.playing = null
+      this.voiceState.preloaded = null
     } else if (this.voiceState.voiceConnection.channel.members.array().length == 1) {
       await this.voiceState.logChannel.send(this.bot.embedFactory.info(
           'Empty voice channel detected. Leaving voice channel...'
@@ -201,78 +272,77 @@ export default class GuildState {
     this.voiceState.queue.push(media)
     if (!this.voiceState.playing) {
       await this.playNextMedia()
+    } else {
+      this.preloadNextMedia()
     }
   }
 
   async playNextMedia(): Promise<void> {
     if (!this.voiceState) throw new Error("Not connected to a voice channel!")
+    if (this.voiceState.queue.length === 0) throw new Error("Queue is empty")
+
+    // The player swaps to the preloaded track on the next frame and calls
+    // onMediaSwap.
+    this.preloadNextMedia()
+    this.voiceState.player.skip()
+  }
+
+  private preloadNextMedia(): void {
+    if (!this.voiceState) throw new Error("Not connected to a voice channel!")
+
+    const media = this.voiceState.queue[0]
+    if (!media || this.voiceState.preloaded === media) return
+
+    this.voiceState.player.preload(GuildState.mediaSlots(media))
+    this.voiceState.preloaded = media
+    debugVideo(`preloaded ${media.title} for guild ${this.id}`)
+  }
+
+  private async onMediaSwap(preloaded: boolean): Promise<void> {
+    if (!this.voiceState) return
+
+    if (!preloaded) {
+      // The track ended with nothing queued after it.
+      this.voiceState.playing = null
+      await this.finishTrack()
+      return
+    }
 
     const media = this.voiceState.queue.shift()
-    if (!media) throw new Error("Queue is empty")
+    if (!media) return
 
+    this.voiceState.preloaded = null
     this.voiceState.playing = {
       currentMedia: media,
       startTime: Date.now(),
     }
-
-    const resources = "both" in media.streamURLs ? [
-      {
-        resource: media.streamURLs.both
-      }
-    ] : [
-      {
-        resource: media.streamURLs.video
-      },
-      {
-        resource: media.streamURLs.audio
-      }
-    ]
-
-    const url = resources[0].resource
-    this.voiceState.sources.audio.updateSettings({
-      close_when_inactive: true,
-      hw_decode: false,
-      input: resources[1] ? resources[1].resource : "",
-      is_local_file: false,
-      seekable: true
-    })
-    this.voiceState.sources.video.updateSettings({
-      close_when_inactive: true,
-      hw_decode: false,
-      input: url,
-      is_local_file: false,
-      seekable: true
-    })
+    this.preloadNextMedia()
 
     await this.voiceState.logChannel.send(this.bot.embedFactory.mediaInfo(media))
   }
 
+  private static mediaSlots(media: QueuedMedia): ObsData[] {
+    const [video, audio] = "both" in media.streamURLs
+        ? [media.streamURLs.both, ""]
+        : [media.streamURLs.video, media.streamURLs.audio]
+
+    return [{input: video}, {input: audio}]
+  }
+
   leaveVoice(): void {
     if (!this.voiceState) throw new Error("Not connected to a voice channel!")
-    this.voiceState.output.stop()
+    this.voiceState.output.release()
+    this.voiceState.view.release()
+    Studio.clearOutputChannel(this.voiceState.mix)
+    usedMixes.delete(this.voiceState.mix)
 
-    for (const item in this.voiceState.sceneItems) {
-      this.voiceState.sceneItems[item].remove()
-    }
+    this.voiceState.videoScene.removeAll()
 
     this.voiceState.voiceConnection.disconnect()
 
-    this.voiceState.sources.video.updateSettings({
-      close_when_inactive: true,
-      hw_decode: false,
-      input: "",
-      is_local_file: false,
-      seekable: true
-    })
-    this.voiceState.sources.audio.updateSettings({
-      close_when_inactive: true,
-      hw_decode: false,
-      input: "",
-      is_local_file: false,
-      seekable: true
-    })
+    this.voiceState.player.release()
+    SourcePool.release(this.voiceState.sources.browser)
 
-    this.voiceState.sceneItems = {}
     this.voiceState.sources = {}
     this.voiceState = null
   }
@@ -283,9 +353,8 @@ export default class GuildState {
     this.config.volume = volume
     this.saveConfig()
 
-    if (this.voiceState.playing) {
-      this.voiceState.audioDispatcher.setVolume(volume)
-    }
+    this.voiceState.sources.video.setVolume(volume)
+    this.voiceState.sources.audio.setVolume(volume)
   }
 
   public get inVoice(): boolean {
@@ -0,0 +1,88 @@
+// Compare SettingsMarshaller with the DataFromObject conversion it replaced,
+// on the settings the bot creates its sources and encoders with. The loops
+// run natively, so build the addon with the benchmark helpers first:
+//
+//   OBS_NODE_BENCHMARKS=ON npm run build
+//   node bench/settings-marshaller.js [iterations]
+//
+// The legacy path leaks its nested objects as it used to, memory grows while
+// it runs.
+require('../dist')
+const {SettingsBenchmark} = require('../prebuild/obs-node.node')
+
+const iterations = Number(process.argv[2] || 100000)
+
+if (!SettingsBenchmark) {
+    console.error('The addon was built without OBS_NODE_BENCHMARKS')
+    process.exit(1)
+}
+
+const cases = [
+    {
+        kind: 'source',
+        id: 'ffmpeg_source',
+        settings: {
+            is_local_file: false,
+            input: 'https://example.com/media/video.mp4',
+            input_format: '',
+            hw_decode: true,
+            buffering_mb: 2,
+            reconnect_delay_sec: 10,
+            restart_on_activate: false,
+            close_when_inactive: true,
+            clear_on_media_end: true,
+            looping: false,
+            speed_percent: 100,
+            color_range: 0,
+        },
+    },
+    {
+        kind: 'source',
+        id: 'browser_source',
+        settings: {
+            is_local_file: true,
+            local_file: '/srv/web-ui/build/index.html',
+            url: '',
+            width: 1920,
+            height: 1080,
+            fps_custom: true,
+            fps: 60,
+            reroute_audio: true,
+            shutdown: false,
+            restart_when_active: false,
+            css: 'body { background-color: rgba(0, 0, 0, 0); margin: 0px auto; overflow: hidden; }',
+        },
+    },
+    {
+        kind: 'encoder',
+        id: 'obs_x264',
+        settings: {
+            profile: 'baseline',
+            rate_control: 'CRF',
+            crf: 25,
+            keyint_sec: 2,
+            preset: 'veryfast',
+            tune: 'zerolatency',
+            x264opts: '',
+        },
+    },
+]
+
+function formatNs(ns) {
+    return ns >= 1000 ? `${(ns / 1000).toFixed(2)} us` : `${ns.toFixed(0)} ns`
+}
+
+console.log(`${iterations} conversions per case`)
+for (const {kind, id, settings} of cases) {
+    // Warm up both paths. The first conversion of a type builds its schema.
+    const {schemaNs} = SettingsBenchmark.run(kind, id, settings, Math.min(1000, iterations))
+    const {marshallerNs, legacyNs} = SettingsBenchmark.run(kind, id, settings, iterations)
+
+    const marshaller = marshallerNs / iterations
+    const legacy = legacyNs / iterations
+    console.log(`${id}:`)
+    console.log(`  SettingsMarshaller  ${formatNs(marshaller)} per conversion`)
+    console.log(`  DataFromObject      ${formatNs(legacy)} per conversion`)
+    console.log(`  speedup             ${(legacy / marshaller).toFixed(2)}x`)
+    console.log(`  schema build        ${formatNs(schemaNs)} once per type`)
+}
@@ -0,0 +1,130 @@
+// Stress StreamOutput's lifecycle: create, start, stop and release outputs in
+// a loop, then check every thread safe function was released and memory
+// stays flat. Run after building with
+//
+//   node --expose-gc bench/stream-output-stress.js [iterations] [runMs]
+//
+// Every thread safe function is a uv_async handle. Those of StreamOutput
+// (onData, onStop, onReadable and one per subscriber) stay referenced until
+// they are released, but they have no JavaScript wrapper, so
+// process._getActiveHandles() does not list them. They are counted in the
+// libuv section of a diagnostic report instead, which lists every handle of
+// the loop with whether it is referenced.
+const {AudioEncoder, StreamOutput, Studio, VideoEncoder} = require('../dist')
+
+const iterations = Number(process.argv[2] || 200)
+const runMs = Number(process.argv[3] || 50)
+// Growth of the heap and RSS tolerated between the warmed up state and the end.
+const maxHeapGrowth = 8 * 1024 * 1024
+const maxRssGrowth = 32 * 1024 * 1024
+const warmupIterations = Math.max(1, Math.min(20, Math.floor(iterations / 4)))
+
+if (typeof global.gc !== 'function') {
+    console.error('Run with --expose-gc')
+    process.exit(1)
+}
+
+Studio.resetVideo({baseWidth: 640, baseHeight: 360, outputWidth: 640, outputHeight: 360, fps: 30})
+Studio.resetAudio({sampleRate: 48000, speakers: 2})
+
+const audioEncoder = new AudioEncoder('ffmpeg_opus', 'Stress Opus Encoder', 0, {bitrate: 64})
+const videoEncoder = new VideoEncoder('obs_x264', 'Stress x264 Encoder', {
+    profile: 'baseline',
+    rate_control: 'CRF',
+    crf: 30,
+})
+
+// The options every mode of StreamOutput is exercised with, in turn.
+const variants = [
+    {},
+    {zeroCopy: false},
+    {batch: {maxPackets: 8, maxLatencyUs: 20000}},
+    {backpressure: {capacity: 64, policy: 'dropUntilKeyframe'}},
+    {pull: {capacity: 64}},
+    {rtp: {mtu: 1200, audio: {ssrc: 1}}},
+]
+
+// Referenced async handles, the ones a leaked StreamOutput function would add.
+function countAsyncHandles() {
+    return process.report.getReport().libuv
+        .filter(handle => handle.type === 'async' && handle.is_referenced).length
+}
+
+function sleep(ms) {
+    return new Promise(resolve => setTimeout(resolve, ms))
+}
+
+async function settle() {
+    // Let released thread safe functions finalize on the loop, then collect.
+    await sleep(10)
+    global.gc()
+    await sleep(10)
+    global.gc()
+}
+
+async function runOnce(i) {
+    const output = new StreamOutput(`Stress Output ${i}`, variants[i % variants.length])
+    let packets = 0
+    output.videoStream.on('data', () => packets++)
+    output.audioStream.on('data', () => packets++)
+    output.setVideoEncoder(videoEncoder)
+    output.setAudioEncoder(audioEncoder)
+    // Every other pass over the variants also exercises a subscriber's function.
+    if (Math.floor(i / variants.length) % 2 === 1) {
+        output.addSubscriber().videoStream.on('data', () => packets++)
+    }
+    output.start()
+    await sleep(runMs)
+    output.stop()
+    output.release()
+    return packets
+}
+
+function formatMb(bytes) {
+    return `${(bytes / 1024 / 1024).toFixed(1)} MB`
+}
+
+async function main() {
+    await settle()
+    const baselineHandles = countAsyncHandles()
+    let packets = 0
+    let warm = null
+    const started = Date.now()
+
+    for (let i = 0; i < iterations; i++) {
+        packets += await runOnce(i)
+        if (i + 1 === warmupIterations) {
+            await settle()
+            warm = process.memoryUsage()
+        }
+    }
+
+    await settle()
+    const handles = countAsyncHandles()
+    const end = process.memoryUsage()
+    const heapGrowth = end.heapUsed - warm.heapUsed
+    const rssGrowth = end.rss - warm.rss
+
+    console.log(`${iterations} outputs in ${Date.now() - started} ms, ${packets} packets`)
+    console.log(`referenced async handles: ${baselineHandles} before, ${handles} after`)
+    console.log(`heap: ${formatMb(warm.heapUsed)} -> ${formatMb(end.heapUsed)}`)
+    console.log(`rss: ${formatMb(warm.rss)} -> ${formatMb(end.rss)}`)
+
+    const failures = []
+    if (handles > baselineHandles) failures.push(`${handles - baselineHandles} thread safe functions leaked`)
+    if (heapGrowth > maxHeapGrowth) failures.push(`heap grew by ${formatMb(heapGrowth)}`)
+    if (rssGrowth > maxRssGrowth) failures.push(`rss grew by ${formatMb(rssGrowth)}`)
+    if (packets === 0) failures.push('no packets were received')
+
+    if (failures.length > 0) {
+        console.error(`FAIL: ${failures.join(', ')}`)
+        process.exit(1)
+    }
+    console.log('OK')
+    process.exit(0)
+}
+
+main().catch(e => {
+    console.error(e)
+    process.exit(1)
+})
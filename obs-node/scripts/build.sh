@@ -119,7 +119,8 @@ if [[ $BUILD_TYPE == 'all' || $BUILD_TYPE == 'obs-node' ]]; then
   fi
   node_modules/.bin/cmake-js configure \
     "$([[ $RELEASE_TYPE == 'Debug' ]] && echo '-D')" \
-    --CDOBS_STUDIO_DIR="${OBS_INSTALL_PREFIX}" 2>&1
+    --CDOBS_STUDIO_DIR="${OBS_INSTALL_PREFIX}" \
+    --CDOBS_NODE_BENCHMARKS="${OBS_NODE_BENCHMARKS:-OFF}" 2>&1
   cmake --build build --config ${RELEASE_TYPE}
 
   # Copy obs-node to prebuild
@@ -0,0 +1,387 @@
+#include "Animator.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <util/platform.h>
+
+static const char *opacityFilterName = "Animation Opacity";
+// Keyframe times in milliseconds are converted to nanoseconds in a uint64_t.
+static constexpr double maxKeyframeTimeMs = 1e12;
+// Keyframe values stay well inside the int range crop values are rounded to,
+// easings overshooting their target included.
+static constexpr double maxKeyframeValue = 1e9;
+
+static const struct {
+  const char *key;
+  AnimatedProperty property;
+} propertyKeys[] = {
+    {"posX", AnimatedProperty::PosX},
+    {"posY", AnimatedProperty::PosY},
+    {"scaleX", AnimatedProperty::ScaleX},
+    {"scaleY", AnimatedProperty::ScaleY},
+    {"rot", AnimatedProperty::Rot},
+    {"cropLeft", AnimatedProperty::CropLeft},
+    {"cropTop", AnimatedProperty::CropTop},
+    {"cropRight", AnimatedProperty::CropRight},
+    {"cropBottom", AnimatedProperty::CropBottom},
+    {"opacity", AnimatedProperty::Opacity},
+};
+
+static const struct {
+  const char *name;
+  Easing easing;
+} easingNames[] = {
+    {"linear", Easing::Linear},
+    {"easeIn", Easing::EaseIn},
+    {"easeOut", Easing::EaseOut},
+    {"easeInOut", Easing::EaseInOut},
+    {"easeOutBack", Easing::EaseOutBack},
+};
+
+static std::mutex animationMutex;
+// Running animations by item, at most one per item.
+static std::map<obs_sceneitem_t *, Animation *> animations;
+static std::once_flag tickRegistered;
+
+static constexpr int Index(AnimatedProperty property) {
+  return static_cast<int>(property);
+}
+
+static double Ease(Easing easing, double t) {
+  switch (easing) {
+    case Easing::EaseIn:
+      return t * t * t;
+    case Easing::EaseOut:
+      return 1 - std::pow(1 - t, 3);
+    case Easing::EaseInOut:
+      return t < 0.5 ? 4 * t * t * t : 1 - std::pow(2 - 2 * t, 3) / 2;
+    case Easing::EaseOutBack:
+      // Overshoots by about 10% before settling.
+      return 1 + 2.70158 * std::pow(t - 1, 3) + 1.70158 * std::pow(t - 1, 2);
+    default:
+      return t;
+  }
+}
+
+/**
+ * Get the value of a track the time passed in after the animation started.
+ * Before the first keyframe the value moves from the start value.
+ */
+static double Evaluate(const std::vector<Keyframe> &track, double startValue, uint64_t elapsed) {
+  uint64_t fromTime = 0;
+  double from = startValue;
+
+  for (const Keyframe &keyframe : track) {
+    if (elapsed < keyframe.timeNs) {
+      double t = static_cast<double>(elapsed - fromTime) / static_cast<double>(keyframe.timeNs - fromTime);
+      return from + (keyframe.value - from) * Ease(keyframe.easing, t);
+    }
+    fromTime = keyframe.timeNs;
+    from = keyframe.value;
+  }
+  return from;
+}
+
+static bool HasTracks(const Animation &animation, AnimatedProperty first, AnimatedProperty last) {
+  for (int i = Index(first); i <= Index(last); i++) {
+    if (!animation.tracks[i].empty()) return true;
+  }
+  return false;
+}
+
+static void ReadValues(Animation &animation, double values[]) {
+  obs_transform_info transform = {};
+  obs_sceneitem_get_info(animation.item, &transform);
+  obs_sceneitem_crop crop = {};
+  obs_sceneitem_get_crop(animation.item, &crop);
+
+  values[Index(AnimatedProperty::PosX)] = transform.pos.x;
+  values[Index(AnimatedProperty::PosY)] = transform.pos.y;
+  values[Index(AnimatedProperty::ScaleX)] = transform.scale.x;
+  values[Index(AnimatedProperty::ScaleY)] = transform.scale.y;
+  values[Index(AnimatedProperty::Rot)] = transform.rot;
+  values[Index(AnimatedProperty::CropLeft)] = crop.left;
+  values[Index(AnimatedProperty::CropTop)] = crop.top;
+  values[Index(AnimatedProperty::CropRight)] = crop.right;
+  values[Index(AnimatedProperty::CropBottom)] = crop.bottom;
+  values[Index(AnimatedProperty::Opacity)] = 1;
+
+  if (animation.opacityFilter != nullptr) {
+    obs_data_t *settings = obs_source_get_settings(animation.opacityFilter);
+    values[Index(AnimatedProperty::Opacity)] = obs_data_get_int(settings, "opacity") / 100.0;
+    obs_data_release(settings);
+  }
+}
+
+/**
+ * Set the property passed in to its value the time passed in after the
+ * animation started, if it is animated.
+ */
+static void Evaluate(const Animation &animation, AnimatedProperty property, uint64_t elapsed, float &value) {
+  const std::vector<Keyframe> &track = animation.tracks[Index(property)];
+  if (track.empty()) return;
+
+  value = static_cast<float>(Evaluate(track, animation.startValues[Index(property)], elapsed));
+}
+
+static void Evaluate(const Animation &animation, AnimatedProperty property, uint64_t elapsed, int &value) {
+  float result = static_cast<float>(value);
+  Evaluate(animation, property, elapsed, result);
+  value = static_cast<int>(std::lround(result));
+}
+
+/**
+ * Set the animated properties of the item to their values the time passed
+ * in after the animation started, leaving the others alone.
+ */
+static void Apply(Animation &animation, uint64_t elapsed) {
+  if (HasTracks(animation, AnimatedProperty::PosX, AnimatedProperty::Rot)) {
+    obs_transform_info transform = {};
+    obs_sceneitem_get_info(animation.item, &transform);
+    Evaluate(animation, AnimatedProperty::PosX, elapsed, transform.pos.x);
+    Evaluate(animation, AnimatedProperty::PosY, elapsed, transform.pos.y);
+    Evaluate(animation, AnimatedProperty::ScaleX, elapsed, transform.scale.x);
+    Evaluate(animation, AnimatedProperty::ScaleY, elapsed, transform.scale.y);
+    Evaluate(animation, AnimatedProperty::Rot, elapsed, transform.rot);
+    obs_sceneitem_set_info(animation.item, &transform);
+  }
+
+  if (HasTracks(animation, AnimatedProperty::CropLeft, AnimatedProperty::CropBottom)) {
+    obs_sceneitem_crop crop = {};
+    obs_sceneitem_get_crop(animation.item, &crop);
+    Evaluate(animation, AnimatedProperty::CropLeft, elapsed, crop.left);
+    Evaluate(animation, AnimatedProperty::CropTop, elapsed, crop.top);
+    Evaluate(animation, AnimatedProperty::CropRight, elapsed, crop.right);
+    Evaluate(animation, AnimatedProperty::CropBottom, elapsed, crop.bottom);
+    obs_sceneitem_set_crop(animation.item, &crop);
+  }
+
+  if (animation.opacityFilter != nullptr) {
+    float opacity = 1;
+    Evaluate(animation, AnimatedProperty::Opacity, elapsed, opacity);
+    int percent = static_cast<int>(std::lround(std::clamp(opacity, 0.0f, 1.0f) * 100));
+    // Updating the filter rebuilds its color matrix, only do so on changes.
+    if (percent != animation.appliedOpacity) {
+      obs_data_t *settings = obs_data_create();
+      obs_data_set_int(settings, "opacity", percent);
+      obs_source_update(animation.opacityFilter, settings);
+      obs_data_release(settings);
+      animation.appliedOpacity = percent;
+    }
+  }
+}
+
+/**
+ * Report the end of an animation and free it. finished is false if it was
+ * stopped, replaced or its item was removed from the scene.
+ */
+static void Finish(Animation *animation, bool finished) {
+  if (static_cast<napi_threadsafe_function>(animation->onComplete) != nullptr) {
+    animation->onComplete.NonBlockingCall([finished](Napi::Env env, Napi::Function callback) {
+      callback.Call({Napi::Boolean::New(env, finished)});
+    });
+    animation->onComplete.Release();
+  }
+
+  obs_source_release(animation->opacityFilter);
+  obs_sceneitem_release(animation->item);
+  delete animation;
+}
+
+static void Tick([[maybe_unused]] void *param, [[maybe_unused]] float seconds) {
+  uint64_t now = os_gettime_ns();
+
+  std::lock_guard<std::mutex> lock(animationMutex);
+  for (auto it = animations.begin(); it != animations.end();) {
+    Animation *animation = it->second;
+
+    if (obs_sceneitem_get_scene(animation->item) == nullptr) {
+      Finish(animation, false);
+      it = animations.erase(it);
+      continue;
+    }
+
+    // Animations start on the first frame after they were started, not when
+    // Node.js got to starting them.
+    if (animation->startedAt == 0) {
+      animation->startedAt = now;
+      ReadValues(*animation, animation->startValues);
+    }
+
+    uint64_t elapsed = now - animation->startedAt;
+    Apply(*animation, std::min(elapsed, animation->durationNs));
+
+    if (elapsed >= animation->durationNs) {
+      Finish(animation, true);
+      it = animations.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+static bool ParseEasing(Napi::Env env, Napi::Value value, Easing &easing) {
+  if (value.IsUndefined()) return true;
+
+  if (value.IsString()) {
+    std::string name = value.ToString().Utf8Value();
+    for (const auto &entry : easingNames) {
+      if (name == entry.name) {
+        easing = entry.easing;
+        return true;
+      }
+    }
+  }
+
+  Napi::TypeError::New(env, "easing must be linear, easeIn, easeOut, easeInOut or easeOutBack")
+      .ThrowAsJavaScriptException();
+  return false;
+}
+
+/**
+ * Get the opacity filter of a source, adding it on first use.
+ */
+static obs_source_t *GetOpacityFilter(obs_source_t *source) {
+  obs_source_t *filter = obs_source_get_filter_by_name(source, opacityFilterName);
+  if (filter != nullptr) return filter;
+
+  filter = obs_source_create_private("color_filter", opacityFilterName, nullptr);
+  if (filter != nullptr) obs_source_filter_add(source, filter);
+  return filter;
+}
+
+Animation *Animator::Create(Napi::Env env, obs_sceneitem_t *item, Napi::Value keyframesValue, Napi::Value optionsValue) {
+  if (!keyframesValue.IsArray() || keyframesValue.As<Napi::Array>().Length() == 0) {
+    Napi::TypeError::New(env, "First argument must be a non-empty array of keyframes")
+        .ThrowAsJavaScriptException();
+    return nullptr;
+  }
+
+  if (!optionsValue.IsUndefined() && !optionsValue.IsObject()) {
+    Napi::TypeError::New(env, "Second argument must be an object")
+        .ThrowAsJavaScriptException();
+    return nullptr;
+  }
+
+  Easing defaultEasing = Easing::Linear;
+  Napi::Value onComplete = env.Undefined();
+  if (optionsValue.IsObject()) {
+    Napi::Object options = optionsValue.ToObject();
+    if (!ParseEasing(env, options.Get("easing"), defaultEasing)) return nullptr;
+
+    onComplete = options.Get("onComplete");
+    if (!onComplete.IsUndefined() && !onComplete.IsFunction()) {
+      Napi::TypeError::New(env, "onComplete must be a function")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+  }
+
+  auto animation = std::make_unique<Animation>();
+  Napi::Array keyframes = keyframesValue.As<Napi::Array>();
+  uint64_t previousTime = 0;
+
+  for (uint32_t i = 0, len = keyframes.Length(); i < len; i++) {
+    Napi::Value value = keyframes.Get(i);
+    if (!value.IsObject()) {
+      Napi::TypeError::New(env, "Keyframes must be objects")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+
+    Napi::Object keyframe = value.ToObject();
+    Napi::Value time = keyframe.Get("time");
+    if (!time.IsNumber()) {
+      Napi::TypeError::New(env, "Keyframe time must be a non-negative number of milliseconds")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+
+    double timeMs = time.As<Napi::Number>().DoubleValue();
+    if (!std::isfinite(timeMs) || timeMs < 0 || timeMs > maxKeyframeTimeMs) {
+      Napi::RangeError::New(env, "Keyframe time must be from 0 to " + std::to_string(static_cast<int64_t>(maxKeyframeTimeMs)) + " milliseconds")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+
+    auto timeNs = static_cast<uint64_t>(timeMs * 1000000);
+    if (timeNs < previousTime) {
+      Napi::RangeError::New(env, "Keyframes must be in time order")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    previousTime = timeNs;
+
+    Easing easing = defaultEasing;
+    if (!ParseEasing(env, keyframe.Get("easing"), easing)) return nullptr;
+
+    for (const auto &entry : propertyKeys) {
+      Napi::Value property = keyframe.Get(entry.key);
+      if (property.IsUndefined()) continue;
+
+      if (!property.IsNumber()) {
+        Napi::TypeError::New(env, std::string("Keyframe ") + entry.key + " must be a number")
+            .ThrowAsJavaScriptException();
+        return nullptr;
+      }
+
+      double propertyValue = property.As<Napi::Number>().DoubleValue();
+      if (!std::isfinite(propertyValue) || std::fabs(propertyValue) > maxKeyframeValue) {
+        Napi::RangeError::New(env, std::string("Keyframe ") + entry.key + " must be a finite number from -1e9 to 1e9")
+            .ThrowAsJavaScriptException();
+        return nullptr;
+      }
+      animation->tracks[Index(entry.property)].push_back({timeNs, propertyValue, easing});
+    }
+  }
+  animation->durationNs = previousTime;
+
+  if (!animation->tracks[Index(AnimatedProperty::Opacity)].empty()) {
+    animation->opacityFilter = GetOpacityFilter(obs_sceneitem_get_source(item));
+    if (animation->opacityFilter == nullptr) {
+      Napi::Error::New(env, "Could not create the opacity filter")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+  }
+
+  if (onComplete.IsFunction()) {
+    animation->onComplete = Napi::ThreadSafeFunction::New(
+        env,
+        onComplete.As<Napi::Function>(),
+        "SceneItem.onComplete",
+        0,
+        1
+    );
+    // A running animation should not keep Node.js alive.
+    animation->onComplete.Unref(env);
+  }
+
+  obs_sceneitem_addref(item);
+  animation->item = item;
+  return animation.release();
+}
+
+void Animator::Start(Animation *animation) {
+  std::call_once(tickRegistered, [] {
+    obs_add_tick_callback(&Tick, nullptr);
+  });
+
+  std::lock_guard<std::mutex> lock(animationMutex);
+  Animation *&running = animations[animation->item];
+  if (running != nullptr) Finish(running, false);
+  running = animation;
+}
+
+bool Animator::Stop(obs_sceneitem_t *item) {
+  std::lock_guard<std::mutex> lock(animationMutex);
+  auto it = animations.find(item);
+  if (it == animations.end()) return false;
+
+  Finish(it->second, false);
+  animations.erase(it);
+  return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <napi.h>
+#include <obs.h>
+
+enum class AnimatedProperty {
+  PosX, PosY, ScaleX, ScaleY, Rot, CropLeft, CropTop, CropRight, CropBottom, Opacity, Count,
+};
+
+enum class Easing {
+  Linear, EaseIn, EaseOut, EaseInOut, EaseOutBack,
+};
+
+struct Keyframe {
+  uint64_t timeNs;
+  double value;
+  // Easing of the motion from the previous keyframe to this one.
+  Easing easing;
+};
+
+struct Animation {
+  obs_sceneitem_t *item = nullptr;
+  // color_filter on the source of the item, only if opacity is animated.
+  obs_source_t *opacityFilter = nullptr;
+  std::vector<Keyframe> tracks[static_cast<int>(AnimatedProperty::Count)];
+  // Values of the properties when the animation started, the start of tracks
+  // that have no keyframe at 0.
+  double startValues[static_cast<int>(AnimatedProperty::Count)] = {};
+  uint64_t durationNs = 0;
+  uint64_t startedAt = 0;
+  int appliedOpacity = -1;
+  Napi::ThreadSafeFunction onComplete;
+};
+
+/**
+ * Keyframed animations of scene items, evaluated natively in a tick callback
+ * on the graphics thread, so motion stays smooth however busy the event loop
+ * is. Node.js only starts animations and is told when they complete.
+ *
+ * Scene items have no opacity of their own in libobs 26, it is animated with
+ * a color_filter added to the source of the item, which affects every scene
+ * showing that source.
+ */
+namespace Animator {
+  /**
+   * Build an animation of the item from an array of keyframe objects and an
+   * options object. Throws and returns nullptr if they are invalid.
+   */
+  Animation *Create(Napi::Env env, obs_sceneitem_t *item, Napi::Value keyframes, Napi::Value options);
+
+  /**
+   * Start an animation, replacing the one of its item if there is one.
+   */
+  void Start(Animation *animation);
+
+  /**
+   * Stop the animation of an item where it is. Returns whether one was running.
+   */
+  bool Stop(obs_sceneitem_t *item);
+};
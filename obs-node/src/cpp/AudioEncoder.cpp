@@ -33,10 +33,11 @@ AudioEncoder::AudioEncoder(const Napi::CallbackInfo &info) : ObjectWrap(info) {
 
   obs_data_t *settings = obs_encoder_defaults(encoderId.c_str());
   if (info[3].IsObject()) {
-    DataFromObject(env, info[3].ToObject(), settings);
+    SettingsMarshaller::Apply(info[3].ToObject(), settings, SettingsKind::Encoder, encoderId);
   }
 
   encoderReference = obs_audio_encoder_create(encoderId.c_str(), name.c_str(), settings, mixIdx, nullptr);
+  obs_data_release(settings);
 
   if (encoderReference == nullptr) {
     Napi::TypeError::New(env, "Could not create encoder object")
@@ -45,7 +46,6 @@ AudioEncoder::AudioEncoder(const Napi::CallbackInfo &info) : ObjectWrap(info) {
   }
 
   obs_encoder_set_audio(encoderReference, obs_get_audio());
-  obs_encoder_update(encoderReference, settings);
 }
 
 AudioEncoder::~AudioEncoder() {
@@ -69,9 +69,10 @@ Napi::Value AudioEncoder::UpdateSettings(const Napi::CallbackInfo &info) {
     return env.Null();
   }
 
-  DataFromObject(env, info[0].ToObject(), settings);
+  SettingsMarshaller::Apply(info[0].ToObject(), settings, SettingsKind::Encoder, encoderId);
 
   obs_encoder_update(encoderReference, settings);
+  obs_data_release(settings);
   return env.Null();
 }
 
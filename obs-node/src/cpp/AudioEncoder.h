@@ -1,6 +1,7 @@
 #pragma once
 #include <napi.h>
 #include <obs.h>
+#include "SettingsMarshaller.h"
 #include "utils.h"
 
 class AudioEncoder: public Napi::ObjectWrap<AudioEncoder> {
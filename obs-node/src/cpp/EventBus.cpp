@@ -0,0 +1,224 @@
+#include "EventBus.h"
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <obs.h>
+
+// Values per event in the array passed to the listener.
+static constexpr uint32_t eventFields = 4;
+// Events collected beyond this within one frame are dropped.
+static constexpr size_t maxPendingEvents = 4096;
+
+static std::mutex busMutex;
+static napi_threadsafe_function busFunction = nullptr;
+static std::vector<SignalEvent> pendingEvents;
+static std::vector<SignalEvent> deliveringEvents;
+static bool flushQueued = false;
+// Incremented on every start. Flushes carry the generation they were queued
+// for, so one still queued from before a restart does not take the events
+// of the new listener.
+static uintptr_t busGeneration = 0;
+
+static uint64_t postedEvents = 0;
+static uint64_t coalescedEvents = 0;
+static uint64_t droppedEvents = 0;
+static uint64_t deliveredBatches = 0;
+
+/**
+ * Whether only the latest value of a signal matters, so repeated signals
+ * can be merged even if their payloads differ.
+ */
+static bool IsLatestValue(ObsSignal signal) {
+  switch (signal) {
+    case ObsSignal::Volume:
+    case ObsSignal::AudioSync:
+    case ObsSignal::AudioMixers:
+    case ObsSignal::UpdateFlags:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool SamePayload(const SignalEvent &a, const SignalEvent &b) {
+  return a.payload == b.payload && a.number == b.number && a.hasState == b.hasState && a.state == b.state &&
+      strcmp(a.text, b.text) == 0;
+}
+
+/**
+ * Tick callback called by OBS once per video frame. Requests a delivery if
+ * events were collected and none is pending yet.
+ */
+static void Tick([[maybe_unused]] void *param, [[maybe_unused]] float seconds) {
+  std::lock_guard<std::mutex> lock(busMutex);
+  if (busFunction == nullptr || pendingEvents.empty() || flushQueued) return;
+
+  if (napi_call_threadsafe_function(busFunction, reinterpret_cast<void *>(busGeneration), napi_tsfn_nonblocking) == napi_ok) {
+    flushQueued = true;
+  }
+}
+
+/**
+ * Deliver the collected events to the listener on the Node.js thread as one
+ * flat array of (handle, signal index, payload, state) tuples.
+ */
+static void CallJs(napi_env env, napi_value jsCallback, [[maybe_unused]] void *context, void *data) {
+  {
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (reinterpret_cast<uintptr_t>(data) != busGeneration) return;
+    deliveringEvents.swap(pendingEvents);
+    flushQueued = false;
+    deliveredBatches++;
+  }
+
+  if (env != nullptr && jsCallback != nullptr && !deliveringEvents.empty()) {
+    Napi::Env napiEnv(env);
+    auto events = Napi::Array::New(napiEnv, deliveringEvents.size() * eventFields);
+    uint32_t i = 0;
+    for (auto &event : deliveringEvents) {
+      Napi::Value payload = napiEnv.Undefined();
+      switch (event.payload) {
+        case SignalEvent::Payload::Boolean:
+          payload = Napi::Boolean::New(napiEnv, event.number != 0);
+          break;
+        case SignalEvent::Payload::Number:
+          payload = Napi::Number::New(napiEnv, event.number);
+          break;
+        case SignalEvent::Payload::String:
+          payload = Napi::String::New(napiEnv, event.text);
+          break;
+        default:
+          break;
+      }
+
+      events.Set(i++, Napi::Number::New(napiEnv, event.handle));
+      events.Set(i++, Napi::Number::New(napiEnv, static_cast<uint8_t>(event.signal)));
+      events.Set(i++, payload);
+      events.Set(i++, event.hasState ? Napi::Boolean::New(napiEnv, event.state) : napiEnv.Undefined());
+    }
+
+    Napi::Function(env, jsCallback).Call({events});
+  }
+
+  // Keep the capacity for the next swap.
+  deliveringEvents.clear();
+}
+
+/**
+ * Queue a signal for the next delivery. Called on whichever thread emitted
+ * the signal. A signal repeating the last event of the same object within
+ * a frame replaces it instead of being queued again.
+ */
+void EventBus::Post(const SignalEvent &event) {
+  std::lock_guard<std::mutex> lock(busMutex);
+  if (busFunction == nullptr) return;
+  postedEvents++;
+
+  for (auto queued = pendingEvents.rbegin(); queued != pendingEvents.rend(); ++queued) {
+    if (queued->handle != event.handle) continue;
+
+    if (queued->signal == event.signal && (IsLatestValue(event.signal) || SamePayload(*queued, event))) {
+      *queued = event;
+      coalescedEvents++;
+      return;
+    }
+    break;
+  }
+
+  if (pendingEvents.size() >= maxPendingEvents) {
+    droppedEvents++;
+    return;
+  }
+
+  pendingEvents.push_back(event);
+}
+
+/**
+ * Start delivering events to the listener passed in. The bus does not keep
+ * the event loop alive on its own.
+ */
+Napi::Value EventBus::Start(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsFunction()) {
+    Napi::TypeError::New(env, "First argument must be a function")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!obs_initialized()) {
+    Napi::Error::New(env, "OBS must be started before the event bus")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (busFunction != nullptr) {
+      Napi::Error::New(env, "The event bus is already started")
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    napi_create_threadsafe_function(
+        env, info[0], nullptr, Napi::String::New(env, "EventBus"),
+        0, 1, nullptr, nullptr, nullptr, &CallJs, &busFunction);
+    napi_unref_threadsafe_function(env, busFunction);
+    busGeneration++;
+  }
+
+  // Outside the bus lock, Tick takes it while OBS holds its tick callback lock.
+  obs_add_tick_callback(&Tick, nullptr);
+
+  return env.Null();
+}
+
+/**
+ * Stop delivering events and discard everything collected.
+ */
+Napi::Value EventBus::Stop(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Remove the tick callback first, it takes the bus lock.
+  if (obs_initialized()) {
+    obs_remove_tick_callback(&Tick, nullptr);
+  }
+
+  std::lock_guard<std::mutex> lock(busMutex);
+  if (busFunction != nullptr) {
+    napi_release_threadsafe_function(busFunction, napi_tsfn_release);
+    busFunction = nullptr;
+  }
+  pendingEvents.clear();
+  // A flush still queued belongs to the old listener and is ignored.
+  flushQueued = false;
+
+  return env.Null();
+}
+
+/**
+ * Get the number of events posted, coalesced and dropped and the number of
+ * batches delivered.
+ */
+Napi::Value EventBus::GetStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::lock_guard<std::mutex> lock(busMutex);
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("postedEvents", Napi::Number::New(env, postedEvents));
+  stats.Set("coalescedEvents", Napi::Number::New(env, coalescedEvents));
+  stats.Set("droppedEvents", Napi::Number::New(env, droppedEvents));
+  stats.Set("deliveredBatches", Napi::Number::New(env, deliveredBatches));
+
+  return stats;
+}
+
+Napi::Object EventBus::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Object eventBusObject = Napi::Object::New(env);
+  eventBusObject.Set(Napi::String::New(env, "start"), Napi::Function::New(env, Start));
+  eventBusObject.Set(Napi::String::New(env, "stop"), Napi::Function::New(env, Stop));
+  eventBusObject.Set(Napi::String::New(env, "getStats"), Napi::Function::New(env, GetStats));
+
+  exports.Set(Napi::String::New(env, "EventBus"), eventBusObject);
+  return exports;
+}
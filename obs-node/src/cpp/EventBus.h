@@ -0,0 +1,21 @@
+#pragma once
+
+#include <napi.h>
+#include "SignalDispatcher.h"
+
+/**
+ * A single channel carrying the signals of every source, scene and output
+ * to Node.js. Events are collected natively, repeated signals are coalesced
+ * and once per video frame everything collected is delivered in one batched
+ * call, so the number of handles and main loop wakeups does not grow with
+ * the number of objects.
+ */
+namespace EventBus {
+  Napi::Value Start(const Napi::CallbackInfo &info);
+  Napi::Value Stop(const Napi::CallbackInfo &info);
+  Napi::Value GetStats(const Napi::CallbackInfo &info);
+
+  void Post(const SignalEvent &event);
+
+  Napi::Object Init(Napi::Env env, Napi::Object exports);
+};
@@ -0,0 +1,251 @@
+#include "LevelMeter.h"
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <obs.h>
+#include <util/platform.h>
+#include "Source.h"
+
+// Values per meter in the array passed to the listener.
+static constexpr uint32_t meterFields = 4;
+
+struct Meter {
+  uint32_t id;
+  obs_volmeter_t *volmeter;
+  // Highest peaks and the latest RMS level since the last report, in dBFS.
+  float peak;
+  float magnitude;
+  float inputPeak;
+  bool updated;
+};
+
+static std::mutex meterMutex;
+static napi_threadsafe_function meterFunction = nullptr;
+static std::map<uint32_t, std::unique_ptr<Meter>> meters;
+static uint32_t nextMeterId = 1;
+static uint64_t intervalNs = 50000000;
+static uint64_t lastReport = 0;
+static bool reportQueued = false;
+
+static void ResetLevels(Meter &meter) {
+  meter.peak = -std::numeric_limits<float>::infinity();
+  meter.magnitude = -std::numeric_limits<float>::infinity();
+  meter.inputPeak = -std::numeric_limits<float>::infinity();
+  meter.updated = false;
+}
+
+static float MaxLevel(const float levels[MAX_AUDIO_CHANNELS], int channels) {
+  float level = -std::numeric_limits<float>::infinity();
+  for (int i = 0; i < channels; i++) {
+    level = std::fmax(level, levels[i]);
+  }
+  return level;
+}
+
+/**
+ * Volume meter callback, called on the audio thread for every audio tick.
+ * Accumulates the levels and requests a report once the interval passed.
+ */
+static void OnLevels(void *param, const float magnitude[MAX_AUDIO_CHANNELS],
+                     const float peak[MAX_AUDIO_CHANNELS], const float inputPeak[MAX_AUDIO_CHANNELS]) {
+  auto *meter = static_cast<Meter *>(param);
+  int channels = obs_volmeter_get_nr_channels(meter->volmeter);
+
+  std::lock_guard<std::mutex> lock(meterMutex);
+  meter->peak = std::fmax(meter->peak, MaxLevel(peak, channels));
+  meter->inputPeak = std::fmax(meter->inputPeak, MaxLevel(inputPeak, channels));
+  meter->magnitude = MaxLevel(magnitude, channels);
+  meter->updated = true;
+
+  uint64_t now = os_gettime_ns();
+  if (meterFunction == nullptr || reportQueued || now - lastReport < intervalNs) return;
+
+  if (napi_call_threadsafe_function(meterFunction, nullptr, napi_tsfn_nonblocking) == napi_ok) {
+    reportQueued = true;
+    lastReport = now;
+  }
+}
+
+/**
+ * Deliver the levels of every meter updated since the last report as one
+ * flat Float64Array of (id, peak, RMS, input peak) tuples.
+ */
+static void CallJs(napi_env env, napi_value jsCallback, [[maybe_unused]] void *context, [[maybe_unused]] void *data) {
+  if (env == nullptr || jsCallback == nullptr) return;
+
+  Napi::Env napiEnv(env);
+  Napi::Float64Array levels;
+  {
+    std::lock_guard<std::mutex> lock(meterMutex);
+    reportQueued = false;
+
+    size_t count = 0;
+    for (auto &entry : meters) {
+      if (entry.second->updated) count++;
+    }
+
+    levels = Napi::Float64Array::New(napiEnv, count * meterFields);
+    size_t i = 0;
+    for (auto &entry : meters) {
+      Meter &meter = *entry.second;
+      if (!meter.updated) continue;
+
+      levels[i++] = meter.id;
+      levels[i++] = meter.peak;
+      levels[i++] = meter.magnitude;
+      levels[i++] = meter.inputPeak;
+      ResetLevels(meter);
+    }
+  }
+
+  if (levels.ElementLength() > 0) {
+    Napi::Function(env, jsCallback).Call({levels});
+  }
+}
+
+/**
+ * Start reporting levels to the listener passed in, at most once per the
+ * interval in milliseconds passed in. The meter does not keep the event
+ * loop alive on its own.
+ */
+Napi::Value LevelMeter::Start(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsFunction()) {
+    Napi::TypeError::New(env, "First argument must be a function")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!info[1].IsUndefined() && (!info[1].IsNumber() || info[1].As<Napi::Number>().DoubleValue() <= 0)) {
+    Napi::TypeError::New(env, "Second argument must be a positive number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::lock_guard<std::mutex> lock(meterMutex);
+  if (meterFunction != nullptr) {
+    Napi::Error::New(env, "The level meter is already started")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (info[1].IsNumber()) {
+    intervalNs = static_cast<uint64_t>(info[1].As<Napi::Number>().DoubleValue() * 1000000);
+  }
+
+  napi_create_threadsafe_function(
+      env, info[0], nullptr, Napi::String::New(env, "LevelMeter"),
+      0, 1, nullptr, nullptr, nullptr, &CallJs, &meterFunction);
+  napi_unref_threadsafe_function(env, meterFunction);
+
+  return env.Null();
+}
+
+/**
+ * Stop reporting levels. Meters stay attached and report again once the
+ * meter is started again.
+ */
+Napi::Value LevelMeter::Stop(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::lock_guard<std::mutex> lock(meterMutex);
+  if (meterFunction != nullptr) {
+    napi_release_threadsafe_function(meterFunction, napi_tsfn_release);
+    meterFunction = nullptr;
+  }
+  reportQueued = false;
+
+  return env.Null();
+}
+
+/**
+ * Meter the source passed in. Returns the id its levels are reported with.
+ */
+Napi::Value LevelMeter::Add(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be a source object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *source = nullptr;
+  try {
+    source = Source::Unwrap(info[0].ToObject().Get("source").ToObject())->sourceReference;
+  } catch (const std::exception &e) {
+    Napi::TypeError::New(env, "First argument must be a source object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (source == nullptr || (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO) == 0) {
+    Napi::TypeError::New(env, "Source has no audio")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto meter = std::make_unique<Meter>();
+  meter->volmeter = obs_volmeter_create(OBS_FADER_LOG);
+  obs_volmeter_set_peak_meter_type(meter->volmeter, SAMPLE_PEAK_METER);
+  ResetLevels(*meter);
+
+  Meter *added = meter.get();
+  {
+    std::lock_guard<std::mutex> lock(meterMutex);
+    meter->id = nextMeterId++;
+    meters[meter->id] = std::move(meter);
+  }
+
+  // Outside the meter lock, the volume meter holds its own lock while it
+  // calls OnLevels.
+  obs_volmeter_add_callback(added->volmeter, &OnLevels, added);
+  obs_volmeter_attach_source(added->volmeter, source);
+
+  return Napi::Number::New(env, added->id);
+}
+
+/**
+ * Stop metering the source with the id passed in. Returns whether it was
+ * metered.
+ */
+Napi::Value LevelMeter::Remove(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::unique_ptr<Meter> meter;
+  {
+    std::lock_guard<std::mutex> lock(meterMutex);
+    auto entry = meters.find(info[0].As<Napi::Number>().Uint32Value());
+    if (entry == meters.end()) return Napi::Boolean::New(env, false);
+
+    meter = std::move(entry->second);
+    meters.erase(entry);
+  }
+
+  // Removing the callback waits for a running one, the meter can be freed after.
+  obs_volmeter_remove_callback(meter->volmeter, &OnLevels, meter.get());
+  obs_volmeter_detach_source(meter->volmeter);
+  obs_volmeter_destroy(meter->volmeter);
+
+  return Napi::Boolean::New(env, true);
+}
+
+Napi::Object LevelMeter::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Object levelMeterObject = Napi::Object::New(env);
+  levelMeterObject.Set(Napi::String::New(env, "start"), Napi::Function::New(env, Start));
+  levelMeterObject.Set(Napi::String::New(env, "stop"), Napi::Function::New(env, Stop));
+  levelMeterObject.Set(Napi::String::New(env, "add"), Napi::Function::New(env, Add));
+  levelMeterObject.Set(Napi::String::New(env, "remove"), Napi::Function::New(env, Remove));
+
+  exports.Set(Napi::String::New(env, "LevelMeter"), levelMeterObject);
+  return exports;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <napi.h>
+
+/**
+ * Audio level meters for any number of sources, reported to Node.js in one
+ * batched call. Every metered source gets an obs_volmeter, its levels are
+ * accumulated natively between reports and delivered at most once per
+ * interval as a flat Float64Array.
+ */
+namespace LevelMeter {
+  Napi::Value Start(const Napi::CallbackInfo &info);
+  Napi::Value Stop(const Napi::CallbackInfo &info);
+  Napi::Value Add(const Napi::CallbackInfo &info);
+  Napi::Value Remove(const Napi::CallbackInfo &info);
+
+  Napi::Object Init(Napi::Env env, Napi::Object exports);
+};
@@ -0,0 +1,449 @@
+#include "MediaPlayer.h"
+#include "Source.h"
+
+MediaPlayer::MediaPlayer(const Napi::CallbackInfo &info) : ObjectWrap(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3) {
+    Napi::TypeError::New(env, "Wrong number of arguments")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!info[1].IsArray() || info[1].As<Napi::Array>().Length() == 0) {
+    Napi::TypeError::New(env, "Second argument must be a non-empty array of slot settings")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!info[2].IsObject()) {
+    Napi::TypeError::New(env, "Third argument must be an object")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  name = info[0].ToString().Utf8Value();
+  Napi::Object options = info[2].ToObject();
+
+  Napi::Value swapCallback = options.Get("onSwap");
+  if (!swapCallback.IsFunction()) {
+    Napi::TypeError::New(env, "onSwap must be a function")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Value transition = options.Get("transition");
+  if (!transition.IsUndefined()) {
+    if (!transition.IsObject()) {
+      Napi::TypeError::New(env, "transition must be an object")
+          .ThrowAsJavaScriptException();
+      return;
+    }
+
+    Napi::Value id = transition.ToObject().Get("id");
+    if (!id.IsUndefined()) {
+      if (!id.IsString()) {
+        Napi::TypeError::New(env, "transition.id must be a string")
+            .ThrowAsJavaScriptException();
+        return;
+      }
+      transitionId = id.ToString().Utf8Value();
+    }
+
+    Napi::Value duration = transition.ToObject().Get("duration");
+    if (!duration.IsUndefined()) {
+      if (!duration.IsNumber() || duration.As<Napi::Number>().Int64Value() < 0) {
+        Napi::TypeError::New(env, "transition.duration must be a non-negative number")
+            .ThrowAsJavaScriptException();
+        return;
+      }
+      transitionDurationMs = duration.As<Napi::Number>().Uint32Value();
+    }
+  }
+
+  Napi::Value mixersValue = options.Get("mixers");
+  if (!mixersValue.IsUndefined()) {
+    if (!mixersValue.IsNumber() || mixersValue.As<Napi::Number>().Int64Value() <= 0 ||
+        mixersValue.As<Napi::Number>().Int64Value() >= (1 << MAX_AUDIO_MIXES)) {
+      Napi::RangeError::New(env, "mixers must be a non-empty mask of the " + std::to_string(MAX_AUDIO_MIXES) + " audio tracks")
+          .ThrowAsJavaScriptException();
+      return;
+    }
+    mixers = mixersValue.As<Napi::Number>().Uint32Value();
+  }
+
+  Napi::Array slotSettings = info[1].As<Napi::Array>();
+  for (uint32_t i = 0, len = slotSettings.Length(); i < len; i++) {
+    if (!CreateSlot(env, slotSettings.Get(i), i)) return;
+  }
+
+  onSwap = Napi::ThreadSafeFunction::New(
+      env,
+      swapCallback.As<Napi::Function>(),
+      "MediaPlayer.onSwap",
+      0,
+      1
+  );
+  // Swaps only happen while media plays, they should not keep Node.js alive.
+  onSwap.Unref(env);
+
+  for (Slot &slot : slots) {
+    for (obs_source_t *player : slot.players) {
+      signal_handler_connect(obs_source_get_signal_handler(player), "media_started", &MediaPlayer::OnMediaStarted, this);
+    }
+  }
+  // The first slot decides when an item is over.
+  for (obs_source_t *player : slots[0].players) {
+    signal_handler_connect(obs_source_get_signal_handler(player), "media_ended", &MediaPlayer::OnMediaEnded, this);
+  }
+  // The transitions of all slots start on the same frame with the same duration.
+  signal_handler_connect(obs_source_get_signal_handler(slots[0].transition), "transition_stop",
+                         &MediaPlayer::OnTransitionStop, this);
+
+  obs_add_tick_callback(&MediaPlayer::Tick, this);
+  ticking = true;
+}
+
+MediaPlayer::~MediaPlayer() {
+  Destroy();
+}
+
+/**
+ * Stop playing and release the transitions and players of every slot. The
+ * sources stay alive as long as scenes still show them.
+ */
+void MediaPlayer::Destroy() {
+  if (obs_initialized()) {
+    // Once removed, the tick callback is not running and will not run again.
+    if (ticking) obs_remove_tick_callback(&MediaPlayer::Tick, this);
+
+    for (Slot &slot : slots) {
+      for (obs_source_t *player : slot.players) {
+        if (player == nullptr) continue;
+
+        signal_handler_t *handler = obs_source_get_signal_handler(player);
+        signal_handler_disconnect(handler, "media_started", &MediaPlayer::OnMediaStarted, this);
+        signal_handler_disconnect(handler, "media_ended", &MediaPlayer::OnMediaEnded, this);
+        obs_source_media_stop(player);
+        obs_source_release(player);
+      }
+      if (slot.transition != nullptr) {
+        signal_handler_disconnect(obs_source_get_signal_handler(slot.transition), "transition_stop",
+                                  &MediaPlayer::OnTransitionStop, this);
+        obs_source_release(slot.transition);
+      }
+    }
+  }
+  ticking = false;
+  slots.clear();
+
+  if (static_cast<napi_threadsafe_function>(onSwap) != nullptr) {
+    onSwap.Release();
+    onSwap = Napi::ThreadSafeFunction();
+  }
+}
+
+/**
+ * Throw if the player has been released. Returns whether it has.
+ */
+bool MediaPlayer::CheckReleased(Napi::Env env) {
+  if (!slots.empty()) return false;
+
+  Napi::Error::New(env, "The media player has been released")
+      .ThrowAsJavaScriptException();
+  return true;
+}
+
+/**
+ * Create the transition of a slot and the two ffmpeg_sources it switches
+ * between, both with the settings passed in.
+ */
+bool MediaPlayer::CreateSlot(Napi::Env env, Napi::Value settings, uint32_t index) {
+  if (!settings.IsUndefined() && !settings.IsNull() && !settings.IsObject()) {
+    Napi::TypeError::New(env, "Slot settings must be objects")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  std::string slotName = name + " " + std::to_string(index);
+  obs_source_t *transition = obs_source_create_private(transitionId.c_str(), slotName.c_str(), nullptr);
+
+  if (transition == nullptr || obs_source_get_type(transition) != OBS_SOURCE_TYPE_TRANSITION) {
+    obs_source_release(transition);
+    Napi::TypeError::New(env, "Could not create transition")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  slots.emplace_back();
+  Slot &slot = slots.back();
+  slot.transition = transition;
+
+  obs_video_info video = {};
+  if (obs_get_video_info(&video)) {
+    obs_transition_set_size(transition, video.base_width, video.base_height);
+  }
+  obs_transition_set_scale_type(transition, OBS_TRANSITION_SCALE_ASPECT);
+  obs_source_set_audio_mixers(transition, mixers);
+
+  obs_data_t *data = obs_get_source_defaults("ffmpeg_source");
+  if (settings.IsObject()) {
+    SettingsMarshaller::Apply(settings.ToObject(), data, SettingsKind::Source, "ffmpeg_source");
+  }
+  // The standby player has to open its media while it is not shown.
+  obs_data_set_bool(data, "close_when_inactive", false);
+  obs_data_set_bool(data, "restart_on_activate", false);
+
+  for (int i = 0; i < 2; i++) {
+    std::string playerName = slotName + (i == 0 ? " A" : " B");
+    slot.players[i] = obs_source_create_private("ffmpeg_source", playerName.c_str(), data);
+  }
+  obs_data_release(data);
+
+  if (slot.players[0] == nullptr || slot.players[1] == nullptr) {
+    Napi::TypeError::New(env, "Could not create media source")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  obs_source_set_audio_mixers(slot.players[0], mixers);
+  obs_source_set_audio_mixers(slot.players[1], mixers);
+  obs_transition_set(transition, slot.players[0]);
+  return true;
+}
+
+/**
+ * Get the source of a slot, to be added to a scene.
+ */
+Napi::Value MediaPlayer::GetSource(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (CheckReleased(env)) return env.Null();
+
+  if (!info[0].IsNumber() || info[0].As<Napi::Number>().Uint32Value() >= slots.size()) {
+    Napi::TypeError::New(env, "First argument must be a slot index")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return Source::FromReference(env, slots[info[0].As<Napi::Number>().Uint32Value()].transition);
+}
+
+/**
+ * Open the next item in the standby players, one settings object per slot.
+ * Slots without settings play nothing. The media is paused as soon as it
+ * starts and resumes when it is swapped in.
+ */
+Napi::Value MediaPlayer::Preload(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (CheckReleased(env)) return env.Null();
+
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "First argument must be an array of settings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Array items = info[0].As<Napi::Array>();
+  std::lock_guard<std::mutex> lock(mutex);
+  int standby = 1 - active;
+  // Players still fading out are replaced by the new item instead of stopped.
+  outgoing = -1;
+
+  for (uint32_t i = 0; i < slots.size(); i++) {
+    Napi::Value item = items.Get(i);
+    obs_data_t *settings = obs_data_create();
+
+    if (item.IsObject()) {
+      SettingsMarshaller::Apply(item.ToObject(), settings, SettingsKind::Source, "ffmpeg_source");
+    } else {
+      obs_data_set_string(settings, "input", "");
+      obs_data_set_string(settings, "local_file", "");
+    }
+    obs_data_set_bool(settings, "close_when_inactive", false);
+    obs_data_set_bool(settings, "restart_on_activate", false);
+
+    obs_source_update(slots[i].players[standby], settings);
+    obs_data_release(settings);
+  }
+
+  standbyLoaded = true;
+  return env.Null();
+}
+
+Napi::Value MediaPlayer::HasPreloaded(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Boolean::New(env, standbyLoaded);
+}
+
+/**
+ * Swap to the preloaded item on the next frame, or stop if there is none.
+ * onSwap is called either way.
+ */
+Napi::Value MediaPlayer::Skip(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (CheckReleased(env)) return env.Null();
+
+  swapRequested = true;
+  return env.Null();
+}
+
+/**
+ * Stop both the playing and the preloaded item without calling onSwap.
+ */
+Napi::Value MediaPlayer::Stop(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (CheckReleased(env)) return env.Null();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  playing = false;
+  standbyLoaded = false;
+  swapRequested = false;
+  outgoing = -1;
+
+  for (Slot &slot : slots) {
+    obs_source_media_stop(slot.players[0]);
+    obs_source_media_stop(slot.players[1]);
+  }
+
+  return env.Null();
+}
+
+/**
+ * Show the standby players in every slot and start them. Called on the
+ * graphics thread with the mutex held.
+ */
+void MediaPlayer::Swap() {
+  bool preloaded = standbyLoaded;
+  int current = active;
+
+  if (preloaded) {
+    int next = 1 - current;
+    // Switch first, stopping the current players ends them.
+    active = next;
+    standbyLoaded = false;
+    playing = true;
+
+    // The current players keep playing while they fade out.
+    outgoing = transitionDurationMs > 0 ? current : -1;
+    transitionEnded = false;
+
+    for (Slot &slot : slots) {
+      obs_source_t *incoming = slot.players[next];
+
+      if (transitionDurationMs > 0) {
+        obs_transition_start(slot.transition, OBS_TRANSITION_MODE_AUTO, transitionDurationMs, incoming);
+      } else {
+        obs_transition_set(slot.transition, incoming);
+        obs_source_media_stop(slot.players[current]);
+      }
+      obs_source_media_play_pause(incoming, false);
+    }
+  } else {
+    playing = false;
+    outgoing = -1;
+
+    for (Slot &slot : slots) {
+      obs_source_media_stop(slot.players[current]);
+    }
+  }
+
+  onSwap.NonBlockingCall([preloaded](Napi::Env env, Napi::Function callback) {
+    callback.Call({Napi::Boolean::New(env, preloaded)});
+  });
+}
+
+/**
+ * Pause preloaded media as soon as it starts. ffmpeg_source opens and starts
+ * its media in the deferred update on the graphics thread.
+ */
+void MediaPlayer::OnMediaStarted(void *param, calldata_t *data) {
+  auto *player = static_cast<MediaPlayer *>(param);
+  auto *source = static_cast<obs_source_t *>(calldata_ptr(data, "source"));
+
+  if (!player->standbyLoaded) return;
+
+  int standby = 1 - player->active;
+  for (Slot &slot : player->slots) {
+    if (slot.players[standby] == source) {
+      obs_source_media_play_pause(source, true);
+      return;
+    }
+  }
+}
+
+/**
+ * Swap when the item of the first slot ends. Reloading the standby players
+ * and stopping the current ones end them as well, which is ignored.
+ */
+void MediaPlayer::OnMediaEnded(void *param, calldata_t *data) {
+  auto *player = static_cast<MediaPlayer *>(param);
+  auto *source = static_cast<obs_source_t *>(calldata_ptr(data, "source"));
+
+  if (!player->playing || source != player->slots[0].players[player->active]) return;
+  player->swapRequested = true;
+}
+
+/**
+ * Note that the transitions ended, the outgoing players are stopped on the
+ * next tick. Called on the graphics thread while transitions are ticked,
+ * where the mutex cannot be waited for.
+ */
+void MediaPlayer::OnTransitionStop(void *param, [[maybe_unused]] calldata_t *data) {
+  auto *player = static_cast<MediaPlayer *>(param);
+  player->transitionEnded = true;
+}
+
+void MediaPlayer::Tick(void *param, [[maybe_unused]] float seconds) {
+  auto *player = static_cast<MediaPlayer *>(param);
+  if (!player->swapRequested && !player->transitionEnded) return;
+
+  // Try again on the next frame while an item is being preloaded.
+  std::unique_lock<std::mutex> lock(player->mutex, std::try_to_lock);
+  if (!lock.owns_lock()) return;
+
+  if (player->transitionEnded) {
+    player->transitionEnded = false;
+    int previous = player->outgoing.exchange(-1);
+    if (previous >= 0) {
+      for (Slot &slot : player->slots) {
+        obs_source_media_stop(slot.players[previous]);
+      }
+    }
+  }
+
+  if (!player->swapRequested) return;
+  player->swapRequested = false;
+  player->Swap();
+}
+
+/**
+ * Free the player without waiting for it to be collected. Remove its sources
+ * from scenes first.
+ */
+Napi::Value MediaPlayer::Release(const Napi::CallbackInfo &info) {
+  Destroy();
+  return info.Env().Null();
+}
+
+Napi::Function MediaPlayer::GetClass(Napi::Env env) {
+  return DefineClass(env, "MediaPlayer", {
+      MediaPlayer::InstanceMethod("getSource", &MediaPlayer::GetSource),
+      MediaPlayer::InstanceMethod("preload", &MediaPlayer::Preload),
+      MediaPlayer::InstanceMethod("hasPreloaded", &MediaPlayer::HasPreloaded),
+      MediaPlayer::InstanceMethod("skip", &MediaPlayer::Skip),
+      MediaPlayer::InstanceMethod("stop", &MediaPlayer::Stop),
+      MediaPlayer::InstanceMethod("release", &MediaPlayer::Release)
+  });
+}
+
+Napi::Object MediaPlayer::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set(Napi::String::New(env, "MediaPlayer"), MediaPlayer::GetClass(env));
+  return exports;
+}
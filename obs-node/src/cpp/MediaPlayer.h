@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <napi.h>
+#include <obs.h>
+#include "SettingsMarshaller.h"
+
+/**
+ * Plays a queue of media without gaps between items.
+ *
+ * Every slot, e.g. the video and the audio of a track, is a transition
+ * showing one of two ffmpeg_sources. The next item is opened and held paused
+ * in the standby sources while the active ones play. When the first slot
+ * ends or skip is called, all slots switch to the standby sources on the
+ * same frame, on the graphics thread. With a transition duration, the
+ * outgoing sources are stopped once the transitions end.
+ */
+class MediaPlayer : public Napi::ObjectWrap<MediaPlayer> {
+public:
+  explicit MediaPlayer(const Napi::CallbackInfo &info);
+  ~MediaPlayer() override;
+
+  Napi::Value GetSource(const Napi::CallbackInfo &info);
+  Napi::Value Preload(const Napi::CallbackInfo &info);
+  Napi::Value HasPreloaded(const Napi::CallbackInfo &info);
+  Napi::Value Skip(const Napi::CallbackInfo &info);
+  Napi::Value Stop(const Napi::CallbackInfo &info);
+  Napi::Value Release(const Napi::CallbackInfo &info);
+
+  static Napi::Function GetClass(Napi::Env env);
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+private:
+  struct Slot {
+    obs_source_t *transition = nullptr;
+    obs_source_t *players[2] = {nullptr, nullptr};
+  };
+
+  bool CreateSlot(Napi::Env env, Napi::Value settings, uint32_t index);
+  bool CheckReleased(Napi::Env env);
+  void Destroy();
+  void Swap();
+  static void OnMediaStarted(void *param, calldata_t *data);
+  static void OnMediaEnded(void *param, calldata_t *data);
+  static void OnTransitionStop(void *param, calldata_t *data);
+  static void Tick(void *param, float seconds);
+
+  std::string name;
+  std::string transitionId = "cut_transition";
+  uint32_t transitionDurationMs = 0;
+  uint32_t mixers = 1;
+  std::vector<Slot> slots;
+  Napi::ThreadSafeFunction onSwap;
+  bool ticking = false;
+
+  // Guards switching the players against preloading into the standby ones.
+  std::mutex mutex;
+  // Index of the players the transitions show.
+  std::atomic<int> active{0};
+  std::atomic<bool> playing{false};
+  std::atomic<bool> swapRequested{false};
+  std::atomic<bool> standbyLoaded{false};
+  // Index of the players fading out, -1 if there are none. They are stopped
+  // on the first tick after the transition of the first slot ends.
+  std::atomic<int> outgoing{-1};
+  std::atomic<bool> transitionEnded{false};
+};
@@ -2,6 +2,7 @@
 #include "VideoEncoder.h"
 #include "AudioEncoder.h"
 #include "OutputService.h"
+#include "SettingsMarshaller.h"
 #include "utils.h"
 
 Output::Output(const Napi::CallbackInfo &info) : ObjectWrap(info) {
@@ -30,18 +31,17 @@ Output::Output(const Napi::CallbackInfo &info) : ObjectWrap(info) {
 
   obs_data_t *settings = obs_output_defaults(outputId.c_str());
   if (info[2].IsObject()) {
-    DataFromObject(env, info[2].ToObject(), settings);
+    SettingsMarshaller::Apply(info[2].ToObject(), settings, SettingsKind::Output, outputId);
   }
 
   outputReference = obs_output_create(outputId.c_str(), name.c_str(), settings, nullptr);
+  obs_data_release(settings);
 
   if (outputReference == nullptr) {
     Napi::TypeError::New(env, "Error creating output")
         .ThrowAsJavaScriptException();
     return;
   }
-
-  obs_output_update(outputReference, settings);
 }
 
 Output::~Output() {
@@ -140,9 +140,10 @@ Napi::Value Output::UpdateSettings(const Napi::CallbackInfo &info) {
   }
 
   obs_data_t *settings = obs_output_get_settings(outputReference);
-  DataFromObject(env, info[0].ToObject(), settings);
+  SettingsMarshaller::Apply(info[0].ToObject(), settings, SettingsKind::Output, outputId);
 
   obs_output_update(outputReference, settings);
+  obs_data_release(settings);
   return env.Null();
 }
 
@@ -150,9 +151,10 @@ Napi::Value Output::GetSettings(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   obs_data_t *settings = obs_output_get_settings(outputReference);
-  const char *json = obs_data_get_json(settings);
+  Napi::String json = Napi::String::New(env, obs_data_get_json(settings));
+  obs_data_release(settings);
 
-  return Napi::String::New(env, json);
+  return json;
 }
 
 Napi::Value Output::SetService(const Napi::CallbackInfo &info) {
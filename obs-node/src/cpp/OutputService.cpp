@@ -25,7 +25,7 @@ OutputService::OutputService(const Napi::CallbackInfo &info)
   serviceId = info[0].ToString().Utf8Value();
   name = info[1].ToString().Utf8Value();
 
-  obs_data_t *settings = obs_output_defaults(serviceId.c_str());
+  obs_data_t *settings = obs_service_defaults(serviceId.c_str());
 
   if (settings == nullptr) {
     Napi::TypeError::New(env, "Could not get default output settings")
@@ -34,10 +34,11 @@ OutputService::OutputService(const Napi::CallbackInfo &info)
   }
 
   if (info[3].IsObject()) {
-    DataFromObject(env, info[3].ToObject(), settings);
+    SettingsMarshaller::Apply(info[3].ToObject(), settings, SettingsKind::Service, serviceId);
   }
 
   serviceReference = obs_service_create(serviceId.c_str(), name.c_str(), settings, nullptr);
+  obs_data_release(settings);
 }
 
 OutputService::~OutputService() {
@@ -61,9 +62,10 @@ Napi::Value OutputService::UpdateSettings(const Napi::CallbackInfo &info) {
     return env.Null();
   }
 
-  DataFromObject(env, info[0].ToObject(), settings);
+  SettingsMarshaller::Apply(info[0].ToObject(), settings, SettingsKind::Service, serviceId);
 
   obs_service_update(serviceReference, settings);
+  obs_data_release(settings);
   return env.Null();
 }
 
@@ -2,6 +2,7 @@
 
 #include <napi.h>
 #include <obs.h>
+#include "SettingsMarshaller.h"
 #include "utils.h"
 
 class OutputService: public Napi::ObjectWrap<OutputService> {
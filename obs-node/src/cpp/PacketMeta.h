@@ -0,0 +1,32 @@
+#pragma once
+#include <obs.h>
+
+/**
+ * Layout of the packet metadata passed to Node.js. Every packet takes
+ * PacketMeta::Fields consecutive doubles of a Float64Array, so a whole batch
+ * can be described without allocating an object per packet.
+ */
+namespace PacketMeta {
+  enum Field {
+    Pts = 0,
+    Dts,
+    TimebaseNum,
+    TimebaseDen,
+    Type,
+    Keyframe,
+    Priority,
+    TrackIdx,
+    Fields
+  };
+
+  inline void Write(double *meta, const encoder_packet &packet) {
+    meta[Pts] = (double)packet.pts;
+    meta[Dts] = (double)packet.dts;
+    meta[TimebaseNum] = packet.timebase_num;
+    meta[TimebaseDen] = packet.timebase_den;
+    meta[Type] = packet.type;
+    meta[Keyframe] = packet.keyframe ? 1 : 0;
+    meta[Priority] = packet.priority;
+    meta[TrackIdx] = (double)packet.track_idx;
+  }
+}
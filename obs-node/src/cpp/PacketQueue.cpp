@@ -0,0 +1,258 @@
+#include "PacketQueue.h"
+#include <util/platform.h>
+
+static bool IsVideoKeyframe(const encoder_packet &packet) {
+  return packet.type == OBS_ENCODER_VIDEO && packet.keyframe;
+}
+
+/**
+ * Create a packet queue. A delivery is requested through requestDelivery
+ * once maxPackets packets are queued or the oldest queued packet is older
+ * than maxLatencyUs, whichever happens first. A maxPackets of 0 disables the
+ * packet limit. The defaults deliver every packet as soon as it arrives.
+ *
+ * A capacity of 0 leaves the queue unbounded, otherwise the policy decides
+ * how a full queue is handled.
+ */
+PacketQueue::PacketQueue(
+  DeliveryCallback requestDelivery,
+  size_t maxPackets,
+  uint64_t maxLatencyUs,
+  size_t capacity,
+  BackpressurePolicy policy
+) {
+  this->requestDelivery = std::move(requestDelivery);
+  this->maxPackets = maxPackets;
+  this->maxLatencyNs = maxLatencyUs * 1000;
+  this->capacity = capacity;
+  this->policy = policy;
+}
+
+PacketQueue::~PacketQueue() {
+  Close();
+  Clear();
+}
+
+/**
+ * Queue a new reference to the packet, applying the backpressure policy if
+ * the queue is full, and request a delivery once per batch.
+ */
+void PacketQueue::Push(encoder_packet *packet) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (closed) return;
+
+  // Once video has been dropped every following frame depends on a frame
+  // Node.js never saw, so skip ahead to the next keyframe.
+  if (packet->type == OBS_ENCODER_VIDEO && waitForKeyframe) {
+    if (!packet->keyframe) {
+      droppedPackets++;
+      droppedBytes += packet->size;
+      return;
+    }
+    waitForKeyframe = false;
+  }
+
+  if (capacity > 0 && packets.size() >= capacity) {
+    bool accepted = MakeRoom(lock);
+
+    // Making room may have started skipping video, which includes this packet.
+    if (accepted && packet->type == OBS_ENCODER_VIDEO && waitForKeyframe) {
+      accepted = packet->keyframe;
+      waitForKeyframe = !packet->keyframe;
+    }
+
+    if (!accepted) {
+      droppedPackets++;
+      droppedBytes += packet->size;
+      return;
+    }
+  }
+
+  uint64_t now = os_gettime_ns();
+  encoder_packet packetRef{};
+  obs_encoder_packet_ref(&packetRef, packet);
+  packets.push_back(packetRef);
+  if (packets.size() == 1) {
+    oldestPacketTime = now;
+  }
+
+  // The latency window is checked as packets arrive, audio packets arrive
+  // every 20ms so a batch is never held much longer than requested.
+  if (!deliveryPending && ShouldDeliver(now)) {
+    RequestDelivery(lock);
+  }
+}
+
+/**
+ * Request delivery of whatever is queued regardless of the batch limits,
+ * used when the output stops.
+ */
+void PacketQueue::Flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  if (!deliveryPending && !packets.empty()) {
+    RequestDelivery(lock);
+  }
+}
+
+/**
+ * Take all queued packets. The caller owns the returned packet references
+ * and must release them.
+ */
+std::vector<encoder_packet> PacketQueue::Drain() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::vector<encoder_packet> result(packets.begin(), packets.end());
+  packets.clear();
+  deliveryPending = false;
+  drained.notify_all();
+  return result;
+}
+
+/**
+ * Release every queued packet without delivering it.
+ */
+void PacketQueue::Clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (auto &packet : packets) {
+    obs_encoder_packet_release(&packet);
+  }
+  packets.clear();
+  deliveryPending = false;
+  drained.notify_all();
+}
+
+/**
+ * Start accepting packets again after the queue was closed.
+ */
+void PacketQueue::Open() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  closed = false;
+  waitForKeyframe = false;
+}
+
+/**
+ * Stop accepting packets and wake up an output thread blocked on a full
+ * queue, so that shutting down never waits on Node.js.
+ */
+void PacketQueue::Close() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  closed = true;
+  drained.notify_all();
+}
+
+bool PacketQueue::IsBatched() const {
+  return maxPackets != 1;
+}
+
+/**
+ * Whether a delivery has been scheduled and not run yet.
+ */
+bool PacketQueue::IsDeliveryPending() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return deliveryPending;
+}
+
+uint64_t PacketQueue::GetDroppedPackets() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return droppedPackets;
+}
+
+uint64_t PacketQueue::GetDroppedBytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return droppedBytes;
+}
+
+size_t PacketQueue::GetQueuedPackets() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return packets.size();
+}
+
+bool PacketQueue::ShouldDeliver(uint64_t now) const {
+  if (maxPackets > 0 && packets.size() >= maxPackets) {
+    return true;
+  }
+  if (capacity > 0 && packets.size() >= capacity) {
+    return true;
+  }
+  return maxLatencyNs > 0 && now - oldestPacketTime >= maxLatencyNs;
+}
+
+/**
+ * Free up space in a full queue according to the policy. Returns false if
+ * the new packet should be dropped instead.
+ */
+bool PacketQueue::MakeRoom(std::unique_lock<std::mutex> &lock) {
+  switch (policy) {
+  case BackpressurePolicy::Block:
+    // A full queue has to be delivered even if the batch is not complete,
+    // otherwise nothing would ever wake us up.
+    if (!deliveryPending) {
+      RequestDelivery(lock);
+      // Nothing would drain the queue if the delivery failed to schedule.
+      if (!deliveryPending && packets.size() >= capacity) return false;
+    }
+    drained.wait(lock, [this] { return closed || packets.size() < capacity; });
+    return !closed;
+
+  case BackpressurePolicy::DropOldestNonKeyframe: {
+    auto victim = packets.begin();
+    while (victim != packets.end() && IsVideoKeyframe(*victim)) {
+      victim++;
+    }
+    Drop(victim != packets.end() ? victim : packets.begin());
+    return true;
+  }
+
+  case BackpressurePolicy::DropUntilKeyframe: {
+    // Throw away all queued video, audio stays intact unless there is no
+    // video left to drop.
+    std::deque<encoder_packet> kept;
+    for (auto &packet : packets) {
+      if (packet.type == OBS_ENCODER_VIDEO) {
+        droppedPackets++;
+        droppedBytes += packet.size;
+        obs_encoder_packet_release(&packet);
+      } else {
+        kept.push_back(packet);
+      }
+    }
+
+    if (kept.size() == packets.size()) {
+      Drop(packets.begin());
+    } else {
+      packets.swap(kept);
+      waitForKeyframe = true;
+    }
+    return true;
+  }
+  }
+
+  return false;
+}
+
+/**
+ * Remove a queued packet, counting it as dropped.
+ */
+void PacketQueue::Drop(std::deque<encoder_packet>::iterator packet) {
+  droppedPackets++;
+  droppedBytes += packet->size;
+  obs_encoder_packet_release(&*packet);
+  packets.erase(packet);
+}
+
+/**
+ * Mark a delivery as pending and call requestDelivery without holding the
+ * lock, since it may call into the thread safe function. If the delivery
+ * could not be scheduled, the next packet requests it again.
+ */
+void PacketQueue::RequestDelivery(std::unique_lock<std::mutex> &lock) {
+  deliveryPending = true;
+  lock.unlock();
+  bool requested = requestDelivery();
+  lock.lock();
+  if (!requested) deliveryPending = false;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <obs.h>
+
+/**
+ * What to do when a bounded packet queue is full.
+ */
+enum class BackpressurePolicy {
+  // Wait on the output thread until Node.js has drained the queue.
+  Block = 0,
+  // Drop the oldest packet that is not a video keyframe.
+  DropOldestNonKeyframe = 1,
+  // Drop queued video and skip new video packets until the next keyframe.
+  DropUntilKeyframe = 2,
+};
+
+/**
+ * Queue of encoded packets waiting to be delivered to Node.js. The output
+ * thread pushes packets as the encoders produce them and the Node.js thread
+ * drains everything that accumulated in one go, which lets several packets
+ * share a single thread safe function call. The queue can be bounded, in
+ * which case the backpressure policy decides what happens when it is full.
+ */
+class PacketQueue {
+public:
+  // Returns false if the delivery could not be scheduled.
+  using DeliveryCallback = std::function<bool()>;
+
+  PacketQueue(DeliveryCallback requestDelivery,
+              size_t maxPackets = 1,
+              uint64_t maxLatencyUs = 0,
+              size_t capacity = 0,
+              BackpressurePolicy policy = BackpressurePolicy::Block);
+  ~PacketQueue();
+
+  void Push(encoder_packet *packet);
+  void Flush();
+  std::vector<encoder_packet> Drain();
+  void Clear();
+  void Open();
+  void Close();
+
+  bool IsBatched() const;
+  bool IsDeliveryPending();
+  uint64_t GetDroppedPackets();
+  uint64_t GetDroppedBytes();
+  size_t GetQueuedPackets();
+
+private:
+  bool ShouldDeliver(uint64_t now) const;
+  bool MakeRoom(std::unique_lock<std::mutex> &lock);
+  void Drop(std::deque<encoder_packet>::iterator packet);
+  void RequestDelivery(std::unique_lock<std::mutex> &lock);
+
+  std::mutex mutex;
+  std::condition_variable drained;
+  std::deque<encoder_packet> packets;
+  DeliveryCallback requestDelivery;
+  size_t maxPackets;
+  uint64_t maxLatencyNs;
+  size_t capacity;
+  BackpressurePolicy policy;
+  uint64_t oldestPacketTime = 0;
+  uint64_t droppedPackets = 0;
+  uint64_t droppedBytes = 0;
+  bool deliveryPending = false;
+  bool waitForKeyframe = false;
+  bool closed = false;
+};
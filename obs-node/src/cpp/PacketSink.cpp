@@ -0,0 +1,210 @@
+#include "PacketSink.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+/**
+ * The sinks delivering through one thread safe function, its context.
+ */
+struct SinkRegistry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<PacketSink>> sinks;
+};
+
+/**
+ * Create a thread safe function for PacketSinks to deliver to callback
+ * through. Its finalizer destroys the sinks, on the Node.js thread, once
+ * no delivery can be pending anymore.
+ */
+Napi::ThreadSafeFunction PacketSink::CreateCallback(Napi::Env env, Napi::Function callback, const char *name) {
+  return Napi::ThreadSafeFunction::New(
+      env,
+      callback,
+      name,
+      0,
+      1,
+      new SinkRegistry(),
+      [](Napi::Env, SinkRegistry *registry) { delete registry; }
+  );
+}
+
+/**
+ * Create a sink delivering through onData, which has to come from
+ * CreateCallback. Sinks of the same function that are closed, idle and no
+ * longer used elsewhere are destroyed here, so restarting an output does
+ * not keep the sinks of its earlier runs. Call on the Node.js thread.
+ */
+std::shared_ptr<PacketSink> PacketSink::Create(
+  Napi::ThreadSafeFunction onData,
+  bool zeroCopy,
+  size_t maxPackets,
+  uint64_t maxLatencyUs,
+  size_t queueCapacity,
+  BackpressurePolicy queuePolicy,
+  bool joinAtKeyframe
+) {
+  auto sink = std::make_shared<PacketSink>(
+      onData, zeroCopy, maxPackets, maxLatencyUs, queueCapacity, queuePolicy, joinAtKeyframe);
+
+  auto *registry = static_cast<SinkRegistry *>(onData.GetContext());
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  auto &sinks = registry->sinks;
+  sinks.erase(std::remove_if(sinks.begin(), sinks.end(), [](const std::shared_ptr<PacketSink> &existing) {
+    return existing.use_count() == 1 && existing->closed && !existing->queue.IsDeliveryPending();
+  }), sinks.end());
+  sinks.push_back(sink);
+  return sink;
+}
+
+/**
+ * Create a packet sink delivering to onData. See PacketQueue for the batch
+ * and backpressure options. A sink that joins at a keyframe ignores every
+ * packet until the first video keyframe, so a consumer attached to a running
+ * output starts with a decodable frame and audio in sync with it.
+ */
+PacketSink::PacketSink(
+  Napi::ThreadSafeFunction onData,
+  bool zeroCopy,
+  size_t maxPackets,
+  uint64_t maxLatencyUs,
+  size_t queueCapacity,
+  BackpressurePolicy queuePolicy,
+  bool joinAtKeyframe
+) : waitForKeyframe(joinAtKeyframe),
+    queue([this] { return RequestDelivery(); }, maxPackets, maxLatencyUs, queueCapacity, queuePolicy) {
+  this->onData = onData;
+  // Whether packets are passed to Node.js without copying them.
+  this->zeroCopy = zeroCopy;
+}
+
+/**
+ * Queue a packet for delivery, called on the output thread.
+ */
+void PacketSink::Push(encoder_packet *packet) {
+  if (waitForKeyframe) {
+    if (packet->type != OBS_ENCODER_VIDEO || !packet->keyframe) return;
+    waitForKeyframe = false;
+  }
+
+  queue.Push(packet);
+}
+
+/**
+ * Deliver whatever is queued regardless of the batch limits.
+ */
+void PacketSink::Flush() {
+  queue.Flush();
+}
+
+void PacketSink::Open() {
+  closed = false;
+  queue.Open();
+}
+
+/**
+ * Stop accepting packets, releasing an output thread blocked on a full queue.
+ */
+void PacketSink::Close() {
+  closed = true;
+  queue.Close();
+}
+
+uint64_t PacketSink::GetDroppedPackets() {
+  return queue.GetDroppedPackets();
+}
+
+uint64_t PacketSink::GetDroppedBytes() {
+  return queue.GetDroppedBytes();
+}
+
+size_t PacketSink::GetQueuedPackets() {
+  return queue.GetQueuedPackets();
+}
+
+/**
+ * Schedule a drain of the packet queue on the Node.js thread. The queue
+ * makes sure at most one drain is pending, so the call never blocks the
+ * output thread and the thread safe function queue stays small. Returns
+ * false if the function is closing and the drain was not scheduled.
+ */
+bool PacketSink::RequestDelivery() {
+  // Call the onData function in Node.js. The lambda is responsible for actually performing the call
+  // with access to the environment of the function, which is required to create objects that are properly
+  // tracked by the runtime. The registry of the function keeps the sink alive until its finalizer.
+  napi_status status = onData.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
+    Deliver(env, jsCallback);
+  });
+  return status == napi_ok;
+}
+
+/**
+ * Drain the packet queue into Node.js. Without batching onData is called
+ * with (data, type, meta) for every packet, with batching it is called once
+ * with an array of packets and the metadata of all of them. The metadata
+ * array is reused between calls and only valid until onData returns.
+ */
+void PacketSink::Deliver(Napi::Env env, Napi::Function jsCallback) {
+  auto packets = queue.Drain();
+  if (packets.empty()) return;
+
+  Napi::Float64Array meta = GetMeta(env, queue.IsBatched() ? packets.size() : 1);
+
+  if (!queue.IsBatched()) {
+    for (auto &packet : packets) {
+      auto type = Napi::Number::New(env, packet.type);
+      PacketMeta::Write(meta.Data(), packet);
+      jsCallback.Call( {PacketToValue(env, packet, zeroCopy), type, meta} );
+    }
+    return;
+  }
+
+  auto array = Napi::Array::New(env, packets.size());
+  for (uint32_t i = 0; i < packets.size(); i++) {
+    PacketMeta::Write(meta.Data() + i * PacketMeta::Fields, packets[i]);
+    array.Set(i, PacketToValue(env, packets[i], zeroCopy));
+  }
+
+  jsCallback.Call( {array, meta} );
+}
+
+/**
+ * Get the shared metadata array, growing it if it cannot describe the given
+ * number of packets.
+ */
+Napi::Float64Array PacketSink::GetMeta(Napi::Env env, size_t packets) {
+  if (metaRef.IsEmpty() || metaRef.Value().ElementLength() < packets * PacketMeta::Fields) {
+    size_t capacity = std::max<size_t>(packets, 64);
+    metaRef = Napi::Persistent(Napi::Float64Array::New(env, capacity * PacketMeta::Fields));
+  }
+
+  return metaRef.Value();
+}
+
+/**
+ * Convert a packet into a Node.js value, taking over the reference held on
+ * it. By default the payload is copied into a new ArrayBuffer, in zero copy
+ * mode it is exposed as an external Buffer which holds the reference until
+ * it is garbage collected.
+ */
+Napi::Value PacketSink::PacketToValue(Napi::Env env, encoder_packet &packet, bool zeroCopy) {
+  if (zeroCopy) {
+    // The Buffer owns our packet reference from here on, the finalizer
+    // releases it once Node.js no longer needs the data.
+    auto packetRef = new encoder_packet(packet);
+    return Napi::Buffer<uint8_t>::New(
+        env, packetRef->data, packetRef->size,
+        [](Napi::Env, uint8_t *, encoder_packet *data) {
+          obs_encoder_packet_release(data);
+          delete data;
+        },
+        packetRef);
+  }
+
+  // Create a Node.js Buffer and copy data into it
+  auto array = Napi::ArrayBuffer::New(env, packet.size);
+  memcpy(array.Data(), packet.data, packet.size);
+
+  // Release the reference we hold on the packet
+  obs_encoder_packet_release(&packet);
+  return array;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <napi.h>
+#include <obs.h>
+#include "PacketMeta.h"
+#include "PacketQueue.h"
+
+/**
+ * A consumer of encoded packets in Node.js. Each sink has its own packet
+ * queue, batching and backpressure policy and delivers to its own onData
+ * callback, so one output can feed several consumers that do not slow each
+ * other down.
+ *
+ * Sinks are created with Create for a thread safe function made by
+ * CreateCallback. The function keeps every sink delivering through it alive
+ * until its finalizer runs on the Node.js thread, so pending deliveries
+ * never own a sink and it is never destroyed on the output thread.
+ */
+class PacketSink {
+public:
+  static Napi::ThreadSafeFunction CreateCallback(Napi::Env env, Napi::Function callback, const char *name);
+  static std::shared_ptr<PacketSink> Create(Napi::ThreadSafeFunction onData,
+                                            bool zeroCopy,
+                                            size_t maxPackets,
+                                            uint64_t maxLatencyUs,
+                                            size_t queueCapacity,
+                                            BackpressurePolicy queuePolicy,
+                                            bool joinAtKeyframe);
+
+  PacketSink(Napi::ThreadSafeFunction onData,
+             bool zeroCopy,
+             size_t maxPackets,
+             uint64_t maxLatencyUs,
+             size_t queueCapacity,
+             BackpressurePolicy queuePolicy,
+             bool joinAtKeyframe);
+
+  void Push(encoder_packet *packet);
+  void Flush();
+  void Open();
+  void Close();
+
+  uint64_t GetDroppedPackets();
+  uint64_t GetDroppedBytes();
+  size_t GetQueuedPackets();
+
+  static Napi::Value PacketToValue(Napi::Env env, encoder_packet &packet, bool zeroCopy);
+
+private:
+  bool RequestDelivery();
+  void Deliver(Napi::Env env, Napi::Function jsCallback);
+  Napi::Float64Array GetMeta(Napi::Env env, size_t packets);
+
+  Napi::ThreadSafeFunction onData;
+  bool zeroCopy;
+  std::atomic<bool> closed{false};
+  std::atomic<bool> waitForKeyframe;
+  PacketQueue queue;
+  Napi::Reference<Napi::Float64Array> metaRef;
+};
@@ -0,0 +1,188 @@
+#include "RtpPacketizer.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <obs-config.h>
+
+// CreatePacket relies on how libobs lays out the payload of packets, which
+// is not part of its API. Checked against libobs 26.0.2, where
+// obs_encoder_packet_ref and obs_encoder_packet_release keep a long
+// reference count directly in front of data and free it with bfree.
+static_assert(LIBOBS_API_MAJOR_VER == 26,
+              "Check the encoder packet layout in libobs/obs-encoder.c before building against another libobs");
+
+static constexpr uint8_t fuaType = 28;
+static constexpr size_t fuaHeaderSize = 2;
+static constexpr size_t rtpHeaderSize = 12;
+static constexpr int64_t opusClockRate = 48000;
+
+static void WriteUInt16BE(uint8_t *out, uint16_t value) {
+  out[0] = value >> 8;
+  out[1] = value & 0xff;
+}
+
+static void WriteUInt32BE(uint8_t *out, uint32_t value) {
+  out[0] = value >> 24;
+  out[1] = (value >> 16) & 0xff;
+  out[2] = (value >> 8) & 0xff;
+  out[3] = value & 0xff;
+}
+
+/**
+ * Find the next Annex-B start code at or after data. Returns end if there is
+ * none, otherwise the position of the start code and its length.
+ */
+static const uint8_t *FindStartCode(const uint8_t *data, const uint8_t *end, size_t &length) {
+  for (const uint8_t *p = data; p + 3 <= end; p++) {
+    if (p[0] != 0 || p[1] != 0) continue;
+
+    if (p[2] == 1) {
+      length = 3;
+      return p;
+    }
+    if (p + 4 <= end && p[2] == 0 && p[3] == 1) {
+      length = 4;
+      return p;
+    }
+  }
+
+  length = 0;
+  return end;
+}
+
+/**
+ * Create an RTP packetizer. The MTU is the largest video payload that will
+ * be produced, not counting the RTP header. An MTU of 0 leaves video alone.
+ */
+RtpPacketizer::RtpPacketizer(size_t mtu) {
+  this->mtu = mtu > 0 ? std::max<size_t>(mtu, fuaHeaderSize + 1) : 0;
+}
+
+/**
+ * Frame audio packets as RTP with the given SSRC and payload type. The
+ * sequence number and timestamp start at random values (RFC 3550).
+ */
+void RtpPacketizer::EnableAudio(uint32_t ssrc, uint8_t payloadType) {
+  std::random_device random;
+  audioEnabled = true;
+  audioSsrc = ssrc;
+  audioPayloadType = payloadType & 0x7f;
+  audioSequence = static_cast<uint16_t>(random());
+  audioTimestampOffset = static_cast<uint32_t>(random());
+}
+
+bool RtpPacketizer::IsVideoEnabled() const {
+  return mtu > 0;
+}
+
+bool RtpPacketizer::IsAudioEnabled() const {
+  return audioEnabled;
+}
+
+/**
+ * Packetize an H.264 video packet into out. The new packet has its own
+ * reference that the caller must release. Returns false if the packet did
+ * not contain any NAL units.
+ */
+bool RtpPacketizer::PacketizeVideo(const encoder_packet *packet, encoder_packet *out) {
+  buffer.clear();
+
+  const uint8_t *end = packet->data + packet->size;
+  size_t startCodeLength = 0;
+  const uint8_t *nal = FindStartCode(packet->data, end, startCodeLength);
+
+  while (nal != end) {
+    nal += startCodeLength;
+    const uint8_t *next = FindStartCode(nal, end, startCodeLength);
+
+    if (next > nal) {
+      WriteNal(nal, next - nal);
+    }
+    nal = next;
+  }
+
+  if (buffer.empty()) {
+    return false;
+  }
+
+  CreatePacket(out, packet, buffer);
+  return true;
+}
+
+/**
+ * Frame an Opus audio packet as a complete RTP packet into out. The new
+ * packet has its own reference that the caller must release. The timestamp
+ * is the packet's pts converted to the 48kHz Opus clock, so gaps in the
+ * encoder output show up as timestamp jumps rather than drift.
+ */
+bool RtpPacketizer::PacketizeAudio(const encoder_packet *packet, encoder_packet *out) {
+  if (packet->size == 0 || packet->timebase_den == 0) {
+    return false;
+  }
+
+  int64_t timestamp = packet->pts * opusClockRate * packet->timebase_num / packet->timebase_den;
+
+  buffer.resize(rtpHeaderSize + packet->size);
+  buffer[0] = 0x80;
+  buffer[1] = audioPayloadType;
+  WriteUInt16BE(&buffer[2], audioSequence++);
+  WriteUInt32BE(&buffer[4], static_cast<uint32_t>(timestamp) + audioTimestampOffset);
+  WriteUInt32BE(&buffer[8], audioSsrc);
+  memcpy(&buffer[rtpHeaderSize], packet->data, packet->size);
+
+  CreatePacket(out, packet, buffer);
+  return true;
+}
+
+/**
+ * Create a reference counted copy of src with its payload replaced by data.
+ * This lays the memory out the same way libobs 26 does for packets it passes
+ * to outputs, a reference count directly in front of the payload, so the
+ * result can be referenced and released like any other packet, see the
+ * static_assert above.
+ */
+void RtpPacketizer::CreatePacket(encoder_packet *dst, const encoder_packet *src, const std::vector<uint8_t> &data) {
+  *dst = *src;
+
+  auto refs = static_cast<long *>(bmalloc(sizeof(long) + data.size()));
+  *refs = 1;
+  dst->data = reinterpret_cast<uint8_t *>(refs + 1);
+  dst->size = data.size();
+  memcpy(dst->data, data.data(), data.size());
+}
+
+/**
+ * Write one NAL unit as a single NAL unit payload, or as FU-A fragments if it
+ * does not fit into the MTU.
+ */
+void RtpPacketizer::WriteNal(const uint8_t *nal, size_t size) {
+  if (size <= mtu) {
+    WritePayloadLength(size);
+    buffer.insert(buffer.end(), nal, nal + size);
+    return;
+  }
+
+  // The FU indicator keeps the NRI bits of the NAL header, the FU header
+  // carries its type. The original NAL header byte itself is not sent.
+  uint8_t indicator = (nal[0] & 0xe0) | fuaType;
+  uint8_t type = nal[0] & 0x1f;
+  size_t maxFragment = mtu - fuaHeaderSize;
+
+  for (size_t offset = 1; offset < size;) {
+    size_t fragment = std::min(maxFragment, size - offset);
+    bool first = offset == 1;
+    bool last = offset + fragment == size;
+
+    WritePayloadLength(fragment + fuaHeaderSize);
+    buffer.push_back(indicator);
+    buffer.push_back(type | (first ? 0x80 : 0) | (last ? 0x40 : 0));
+    buffer.insert(buffer.end(), nal + offset, nal + offset + fragment);
+    offset += fragment;
+  }
+}
+
+void RtpPacketizer::WritePayloadLength(size_t size) {
+  uint8_t length[2];
+  WriteUInt16BE(length, static_cast<uint16_t>(size));
+  buffer.insert(buffer.end(), length, length + 2);
+}
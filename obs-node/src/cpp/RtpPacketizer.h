@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <obs.h>
+
+/**
+ * Turns encoded packets into RTP on the output thread.
+ *
+ * For H.264 video the Annex-B stream is split into NAL units, NAL units
+ * larger than the MTU are split into FU-A fragments (RFC 6184). The payloads
+ * of one packet are written back to back into a new packet, each preceded by
+ * its length as a big endian 16 bit integer. The last payload of a packet
+ * ends the access unit and should be sent with the RTP marker bit set.
+ *
+ * For Opus audio every packet becomes one complete RTP packet, a 12 byte
+ * header with sequence number, 48kHz timestamp and SSRC followed by the
+ * Opus frame (RFC 7587).
+ */
+class RtpPacketizer {
+public:
+  explicit RtpPacketizer(size_t mtu);
+
+  void EnableAudio(uint32_t ssrc, uint8_t payloadType);
+  bool IsVideoEnabled() const;
+  bool IsAudioEnabled() const;
+
+  bool PacketizeVideo(const encoder_packet *packet, encoder_packet *out);
+  bool PacketizeAudio(const encoder_packet *packet, encoder_packet *out);
+
+  static void CreatePacket(encoder_packet *dst, const encoder_packet *src, const std::vector<uint8_t> &data);
+
+private:
+  void WriteNal(const uint8_t *nal, size_t size);
+  void WritePayloadLength(size_t size);
+
+  size_t mtu;
+  std::vector<uint8_t> buffer;
+
+  bool audioEnabled = false;
+  uint32_t audioSsrc = 0;
+  uint8_t audioPayloadType = 0;
+  uint16_t audioSequence = 0;
+  uint32_t audioTimestampOffset = 0;
+};
@@ -1,9 +1,45 @@
 #include "Scene.h"
 #include "SceneItem.h"
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+static bool CollectItem([[maybe_unused]] obs_scene_t *scene, obs_sceneitem_t *item, void *param) {
+  obs_sceneitem_addref(item);
+  static_cast<std::vector<obs_sceneitem_t *> *>(param)->push_back(item);
+  return true;
+}
+
+/**
+ * Get the items of a scene from bottom to top, each with a reference the
+ * caller has to release.
+ */
+static std::vector<obs_sceneitem_t *> CollectItems(obs_scene_t *scene) {
+  std::vector<obs_sceneitem_t *> items;
+  obs_scene_enum_items(scene, &CollectItem, &items);
+  return items;
+}
+
+static void RemoveItems(void *param, [[maybe_unused]] obs_scene_t *scene) {
+  for (obs_sceneitem_t *item : *static_cast<std::vector<obs_sceneitem_t *> *>(param)) {
+    obs_sceneitem_remove(item);
+  }
+}
 
 Scene::Scene(const Napi::CallbackInfo &info): Napi::ObjectWrap<Scene>(info) {
   Napi::Env env = info.Env();
 
+  // Wrap an existing scene, see FromReference.
+  if (info[0].IsExternal()) {
+    sceneReference = info[0].As<Napi::External<obs_scene_t>>().Data();
+    obs_scene_addref(sceneReference);
+    sourceReference = obs_scene_get_source(sceneReference);
+    obs_source_addref(sourceReference);
+    name = obs_source_get_name(sourceReference);
+    return;
+  }
+
   if (info.Length() < 1) {
     Napi::TypeError::New(env, "Wrong number of arguments")
         .ThrowAsJavaScriptException();
@@ -16,12 +52,6 @@ Scene::Scene(const Napi::CallbackInfo &info): Napi::ObjectWrap<Scene>(info) {
     return;
   }
 
-  if (!info[1].IsFunction() && !info[1].IsNull() && !info[1].IsUndefined()) {
-    Napi::TypeError::New(env, "Second argument must be a function or null")
-        .ThrowAsJavaScriptException();
-    return;
-  }
-
   name = info[0].ToString().Utf8Value();
   sceneReference = obs_scene_create(name.c_str());
 
@@ -40,8 +70,6 @@ Scene::Scene(const Napi::CallbackInfo &info): Napi::ObjectWrap<Scene>(info) {
   }
 
   obs_source_addref(sourceReference);
-
-  signalHandler = Napi::Persistent(info[1].As<Napi::Function>());
 }
 
 Scene::~Scene() {
@@ -49,6 +77,12 @@ Scene::~Scene() {
   if (sceneReference != nullptr) obs_scene_release(sceneReference);
 }
 
+Napi::FunctionReference Scene::constructor;
+
+Napi::Object Scene::FromReference(Napi::Env env, obs_scene_t *scene) {
+  return constructor.New({Napi::External<obs_scene_t>::New(env, scene)});
+}
+
 Napi::Value Scene::AddSource(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -68,7 +102,6 @@ Napi::Value Scene::AddSource(const Napi::CallbackInfo &info) {
     Source *source = Source::Unwrap(info[0].ToObject().Get("source").ToObject());
 
     obs_sceneitem_t *sceneItem = obs_scene_add(sceneReference, source->sourceReference);
-    obs_sceneitem_addref(sceneItem);
 
     if (sceneItem == nullptr) {
       Napi::TypeError::New(env, "Could not add source to scene")
@@ -76,11 +109,7 @@ Napi::Value Scene::AddSource(const Napi::CallbackInfo &info) {
       return env.Null();
     }
 
-    Napi::Object napiSceneItem = SceneItem::GetClass(env).New( {Napi::String::New(env, "")} );
-    SceneItem *sceneItemObject = SceneItem::Unwrap(napiSceneItem);
-    sceneItemObject->sceneItemReference = sceneItem;
-
-    return reinterpret_cast<Napi::Value &&>(napiSceneItem);
+    return SceneItem::FromReference(env, sceneItem);
   } catch (const std::exception &e) {
     Napi::TypeError::New(env, "First argument must be a source object")
         .ThrowAsJavaScriptException();
@@ -91,10 +120,9 @@ Napi::Value Scene::AddSource(const Napi::CallbackInfo &info) {
 Napi::Value Scene::AsSource(const Napi::CallbackInfo &info) {
   auto env = info.Env();
 
-  Napi::Object napiSource = Source::GetClass(env).New( {
+  Napi::Object napiSource = Source::constructor.New( {
       Napi::String::New(env, "scene"),
       Napi::String::New(env, name),
-      signalHandler.Value(),
   } );
 
   Source *sourceObject = Source::Unwrap(napiSource);
@@ -105,14 +133,261 @@ Napi::Value Scene::AsSource(const Napi::CallbackInfo &info) {
   return reinterpret_cast<Napi::Value &&>(napiSource);
 }
 
+/**
+ * Get the items of the scene from bottom to top.
+ */
+Napi::Value Scene::GetItems(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::vector<obs_sceneitem_t *> items = CollectItems(sceneReference);
+  Napi::Array array = Napi::Array::New(env, items.size());
+  for (uint32_t i = 0; i < items.size(); i++) {
+    array.Set(i, SceneItem::FromReference(env, items[i]));
+    obs_sceneitem_release(items[i]);
+  }
+
+  return array;
+}
+
+/**
+ * Get the item showing the source with the name passed in, or null.
+ */
+Napi::Value Scene::FindItem(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_sceneitem_t *item = obs_scene_find_source(sceneReference, info[0].ToString().Utf8Value().c_str());
+  if (item == nullptr) return env.Null();
+
+  return SceneItem::FromReference(env, item);
+}
+
+/**
+ * Get the item with the ID passed in, or null.
+ */
+Napi::Value Scene::GetItemById(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_sceneitem_t *item = obs_scene_find_sceneitem_by_id(sceneReference, info[0].As<Napi::Number>().Int64Value());
+  if (item == nullptr) return env.Null();
+
+  return SceneItem::FromReference(env, item);
+}
+
+/**
+ * Remove every item from the scene at once. Returns the number of items
+ * removed.
+ */
+Napi::Value Scene::RemoveAll(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::vector<obs_sceneitem_t *> items = CollectItems(sceneReference);
+  obs_scene_atomic_update(sceneReference, &RemoveItems, &items);
+  for (obs_sceneitem_t *item : items) {
+    obs_sceneitem_release(item);
+  }
+
+  return Napi::Number::New(env, items.size());
+}
+
+/**
+ * Whether a packed value is an integer from min to max, so casting it is
+ * defined.
+ */
+static bool IsIntegerIn(double value, double min, double max) {
+  return std::isfinite(value) && std::trunc(value) == value && value >= min && value <= max;
+}
+
+/**
+ * Whether a packed value fits a float.
+ */
+static bool IsFloat(double value) {
+  return std::isfinite(value) && std::fabs(value) <= FLT_MAX;
+}
+
+/**
+ * Whether the values of a change can be converted to what libobs expects.
+ */
+static bool IsValidChange(SceneItemChange change, const double *values) {
+  switch (change) {
+    case SceneItemChange::Transform:
+      return IsFloat(values[0]) && IsFloat(values[1]) && IsFloat(values[2]) &&
+             IsFloat(values[3]) && IsFloat(values[4]) &&
+             IsIntegerIn(values[5], 0, UINT32_MAX) &&
+             IsIntegerIn(values[6], OBS_BOUNDS_NONE, OBS_BOUNDS_MAX_ONLY) &&
+             IsIntegerIn(values[7], 0, UINT32_MAX) &&
+             IsFloat(values[8]) && IsFloat(values[9]);
+    case SceneItemChange::Crop:
+      for (int i = 0; i < 4; i++) {
+        if (!IsIntegerIn(values[i], 0, INT_MAX)) return false;
+      }
+      return true;
+    case SceneItemChange::Visible:
+      return std::isfinite(values[0]);
+    case SceneItemChange::Order:
+      return IsIntegerIn(values[0], OBS_ORDER_MOVE_UP, OBS_ORDER_MOVE_BOTTOM);
+    case SceneItemChange::OrderPosition:
+      return IsIntegerIn(values[0], 0, INT_MAX);
+    case SceneItemChange::ScaleFilter:
+      return IsIntegerIn(values[0], OBS_SCALE_DISABLE, OBS_SCALE_AREA);
+  }
+  return false;
+}
+
+/**
+ * Apply a transaction of scene item changes packed into a Float64Array in
+ * one atomic update, so no frame is rendered with only some of them
+ * applied. Changes to items that are no longer in the scene are skipped.
+ * Returns the number of changes applied.
+ */
+Napi::Value Scene::ApplyItemChanges(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsTypedArray() || info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "First argument must be a Float64Array")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Float64Array array = info[0].As<Napi::Float64Array>();
+  PackedChanges changes{array.Data(), array.ElementLength(), 0};
+
+  // Validate everything first, a transaction is applied completely or not at all.
+  for (size_t i = 0; i < changes.length;) {
+    int valueCount = i + 1 < changes.length ? GetChangeValues(changes.values[i]) : -1;
+    if (valueCount < 0 || i + 2 + valueCount > changes.length) {
+      Napi::RangeError::New(env, "Malformed scene item change at index " + std::to_string(i))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Item IDs are positive int64_t, exactly representable up to 2^53.
+    auto change = static_cast<SceneItemChange>(static_cast<int>(changes.values[i]));
+    if (!IsIntegerIn(changes.values[i + 1], 0, 9007199254740991.0) ||
+        !IsValidChange(change, changes.values + i + 2)) {
+      Napi::RangeError::New(env, "Invalid value in scene item change at index " + std::to_string(i))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    i += 2 + valueCount;
+  }
+
+  obs_scene_atomic_update(sceneReference, &Scene::ApplyChanges, &changes);
+  return Napi::Number::New(env, changes.applied);
+}
+
+/**
+ * Get the number of values following the item ID of a change, or -1 if
+ * the change is unknown.
+ */
+int Scene::GetChangeValues(double change) {
+  if (!IsIntegerIn(change, 0, static_cast<int>(SceneItemChange::ScaleFilter))) return -1;
+
+  switch (static_cast<int>(change)) {
+    case static_cast<int>(SceneItemChange::Transform):
+      return 10;
+    case static_cast<int>(SceneItemChange::Crop):
+      return 4;
+    case static_cast<int>(SceneItemChange::Visible):
+    case static_cast<int>(SceneItemChange::Order):
+    case static_cast<int>(SceneItemChange::OrderPosition):
+    case static_cast<int>(SceneItemChange::ScaleFilter):
+      return 1;
+    default:
+      return -1;
+  }
+}
+
+/**
+ * Atomic update callback, called with the scene locked. The changes have
+ * been validated by ApplyItemChanges.
+ */
+void Scene::ApplyChanges(void *param, obs_scene_t *scene) {
+  auto *changes = static_cast<PackedChanges *>(param);
+
+  for (size_t i = 0; i < changes->length;) {
+    auto change = static_cast<SceneItemChange>(static_cast<int>(changes->values[i]));
+    auto id = static_cast<int64_t>(changes->values[i + 1]);
+    const double *values = changes->values + i + 2;
+    i += 2 + GetChangeValues(changes->values[i]);
+
+    obs_sceneitem_t *item = obs_scene_find_sceneitem_by_id(scene, id);
+    if (item == nullptr) continue;
+
+    ApplyChange(item, change, values);
+    changes->applied++;
+  }
+}
+
+void Scene::ApplyChange(obs_sceneitem_t *item, SceneItemChange change, const double *values) {
+  switch (change) {
+    case SceneItemChange::Transform: {
+      obs_transform_info transform = {};
+      transform.pos.x = static_cast<float>(values[0]);
+      transform.pos.y = static_cast<float>(values[1]);
+      transform.rot = static_cast<float>(values[2]);
+      transform.scale.x = static_cast<float>(values[3]);
+      transform.scale.y = static_cast<float>(values[4]);
+      transform.alignment = static_cast<uint32_t>(values[5]);
+      transform.bounds_type = static_cast<obs_bounds_type>(values[6]);
+      transform.bounds_alignment = static_cast<uint32_t>(values[7]);
+      transform.bounds.x = static_cast<float>(values[8]);
+      transform.bounds.y = static_cast<float>(values[9]);
+      obs_sceneitem_set_info(item, &transform);
+      break;
+    }
+    case SceneItemChange::Crop: {
+      obs_sceneitem_crop crop = {
+          static_cast<int>(values[0]), static_cast<int>(values[1]),
+          static_cast<int>(values[2]), static_cast<int>(values[3]),
+      };
+      obs_sceneitem_set_crop(item, &crop);
+      break;
+    }
+    case SceneItemChange::Visible:
+      obs_sceneitem_set_visible(item, values[0] != 0);
+      break;
+    case SceneItemChange::Order:
+      obs_sceneitem_set_order(item, static_cast<obs_order_movement>(values[0]));
+      break;
+    case SceneItemChange::OrderPosition:
+      obs_sceneitem_set_order_position(item, static_cast<int>(values[0]));
+      break;
+    case SceneItemChange::ScaleFilter:
+      obs_sceneitem_set_scale_filter(item, static_cast<obs_scale_type>(values[0]));
+      break;
+  }
+}
+
 Napi::Function Scene::GetClass(Napi::Env env) {
   return DefineClass(env, "Scene", {
      Scene::InstanceMethod("addSource", &Scene::AddSource),
-     Scene::InstanceMethod("asSource", &Scene::AsSource)
+     Scene::InstanceMethod("asSource", &Scene::AsSource),
+     Scene::InstanceMethod("applyItemChanges", &Scene::ApplyItemChanges),
+     Scene::InstanceMethod("getItems", &Scene::GetItems),
+     Scene::InstanceMethod("findItem", &Scene::FindItem),
+     Scene::InstanceMethod("getItemById", &Scene::GetItemById),
+     Scene::InstanceMethod("removeAll", &Scene::RemoveAll)
   });
 }
 
 Napi::Object Scene::Init(Napi::Env env, Napi::Object exports) {
-  exports.Set(Napi::String::New(env, "Scene"), Scene::GetClass(env));
+  // Init runs twice, the class is only defined the first time.
+  if (constructor.IsEmpty()) {
+    constructor = Napi::Persistent(Scene::GetClass(env));
+    napi_add_env_cleanup_hook(env, [](void *) { constructor.Reset(); }, nullptr);
+  }
+  exports.Set(Napi::String::New(env, "Scene"), constructor.Value());
   return exports;
 }
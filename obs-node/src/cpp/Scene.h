@@ -5,6 +5,14 @@
 #include <obs.h>
 #include "utils.h"
 
+/**
+ * The scene item changes of a transaction. Each change is packed as the
+ * change, the scene item ID and its values, see GetChangeValues.
+ */
+enum class SceneItemChange : uint8_t {
+  Transform, Crop, Visible, Order, OrderPosition, ScaleFilter,
+};
+
 class Scene: public Napi::ObjectWrap<Scene> {
 public:
   explicit Scene(const Napi::CallbackInfo &info);
@@ -12,12 +20,31 @@ public:
 
   Napi::Value AddSource(const Napi::CallbackInfo &info);
   Napi::Value AsSource(const Napi::CallbackInfo &info);
+  Napi::Value ApplyItemChanges(const Napi::CallbackInfo &info);
+  Napi::Value GetItems(const Napi::CallbackInfo &info);
+  Napi::Value FindItem(const Napi::CallbackInfo &info);
+  Napi::Value GetItemById(const Napi::CallbackInfo &info);
+  Napi::Value RemoveAll(const Napi::CallbackInfo &info);
 
+  static Napi::Object FromReference(Napi::Env env, obs_scene_t *scene);
   static Napi::Function GetClass(Napi::Env env);
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
+  // The class exported by Init, the constructor of every wrapper created
+  // from native code.
+  static Napi::FunctionReference constructor;
+
 private:
-  Napi::FunctionReference signalHandler;
+  struct PackedChanges {
+    const double *values;
+    size_t length;
+    uint32_t applied;
+  };
+
+  static int GetChangeValues(double change);
+  static void ApplyChanges(void *param, obs_scene_t *scene);
+  static void ApplyChange(obs_sceneitem_t *item, SceneItemChange change, const double *values);
+
   std::string name;
   obs_scene_t *sceneReference;
   obs_source_t *sourceReference;
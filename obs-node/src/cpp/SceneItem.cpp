@@ -1,15 +1,49 @@
 #include "SceneItem.h"
+#include <unordered_map>
+#include "Animator.h"
 #include "utils.h"
 
+// The wrapper of every scene item that has one, held weakly so unused
+// wrappers can still be collected.
+static std::unordered_map<obs_sceneitem_t *, Napi::ObjectReference> wrappers;
+
+Napi::FunctionReference SceneItem::constructor;
+
 SceneItem::SceneItem(const Napi::CallbackInfo &info)
     : ObjectWrap(info) {
   memset(&transformInfo, 0, sizeof transformInfo);
+
+  // Wrap an existing scene item, see FromReference.
+  if (info[0].IsExternal()) {
+    sceneItemReference = info[0].As<Napi::External<obs_sceneitem_t>>().Data();
+    obs_sceneitem_addref(sceneItemReference);
+  }
 }
 
 SceneItem::~SceneItem() {
+  auto it = wrappers.find(sceneItemReference);
+  // A new wrapper may have been cached after this one was collected.
+  if (it != wrappers.end() && it->second.Value().IsEmpty()) wrappers.erase(it);
+
   obs_sceneitem_release(sceneItemReference);
 }
 
+/**
+ * Get the SceneItem object of a scene item, the same object for as long as
+ * it is referenced from Node.js.
+ */
+Napi::Object SceneItem::FromReference(Napi::Env env, obs_sceneitem_t *item) {
+  auto it = wrappers.find(item);
+  if (it != wrappers.end()) {
+    Napi::Object wrapper = it->second.Value();
+    if (!wrapper.IsEmpty()) return wrapper;
+  }
+
+  Napi::Object wrapper = constructor.New({Napi::External<obs_sceneitem_t>::New(env, item)});
+  wrappers[item] = Napi::Weak(wrapper);
+  return wrapper;
+}
+
 Napi::Value SceneItem::SetTransformInfo(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -75,15 +109,59 @@ Napi::Value SceneItem::Remove(const Napi::CallbackInfo &info) {
   return env.Null();
 }
 
+/**
+ * Get the ID identifying the item in its scene, used by scene transactions.
+ */
+Napi::Value SceneItem::GetId(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, static_cast<double>(obs_sceneitem_get_id(sceneItemReference)));
+}
+
+/**
+ * Animate the item through an array of keyframes, see Animator.h. Replaces
+ * the running animation of the item, if there is one.
+ */
+Napi::Value SceneItem::Animate(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Animation *animation = Animator::Create(env, sceneItemReference, info[0], info[1]);
+  if (animation == nullptr) return env.Null();
+
+  Animator::Start(animation);
+  return env.Null();
+}
+
+/**
+ * Stop the running animation of the item where it is. Returns whether one
+ * was running.
+ */
+Napi::Value SceneItem::StopAnimation(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Boolean::New(env, Animator::Stop(sceneItemReference));
+}
+
 Napi::Function SceneItem::GetClass(Napi::Env env) {
   return DefineClass(env, "SceneItem", {
     SceneItem::InstanceMethod("setTransformInfo", &SceneItem::SetTransformInfo),
     SceneItem::InstanceMethod("getTransformInfo", &SceneItem::GetTransformInfo),
     SceneItem::InstanceMethod("remove", &SceneItem::Remove),
+    SceneItem::InstanceMethod("getId", &SceneItem::GetId),
+    SceneItem::InstanceMethod("animate", &SceneItem::Animate),
+    SceneItem::InstanceMethod("stopAnimation", &SceneItem::StopAnimation),
   });
 }
 
 Napi::Object SceneItem::Init(Napi::Env env, Napi::Object exports) {
-  exports.Set(Napi::String::New(env, "SceneItem"), SceneItem::GetClass(env));
+  if (constructor.IsEmpty()) {
+    constructor = Napi::Persistent(SceneItem::GetClass(env));
+    // The references would otherwise outlive the env they belong to.
+    napi_add_env_cleanup_hook(env, [](void *) {
+      wrappers.clear();
+      constructor.Reset();
+    }, nullptr);
+  }
+  exports.Set(Napi::String::New(env, "SceneItem"), constructor.Value());
   return exports;
 }
@@ -11,10 +11,18 @@ public:
   Napi::Value SetTransformInfo(const Napi::CallbackInfo &info);
   Napi::Value GetTransformInfo(const Napi::CallbackInfo &info);
   Napi::Value Remove(const Napi::CallbackInfo &info);
+  Napi::Value GetId(const Napi::CallbackInfo &info);
+  Napi::Value Animate(const Napi::CallbackInfo &info);
+  Napi::Value StopAnimation(const Napi::CallbackInfo &info);
 
+  static Napi::Object FromReference(Napi::Env env, obs_sceneitem_t *item);
   static Napi::Function GetClass(Napi::Env env);
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
+  // The class exported by Init, the constructor of every wrapper created
+  // from native code.
+  static Napi::FunctionReference constructor;
+
   obs_sceneitem_t *sceneItemReference = nullptr;
 
 private:
@@ -0,0 +1,122 @@
+#include "SettingsBenchmark.h"
+#include <obs.h>
+#include <util/platform.h>
+#include "SettingsMarshaller.h"
+
+static obs_data_array_t *LegacyArrayFromObject(Napi::Env env, Napi::Array array);
+
+/**
+ * The conversion SettingsMarshaller replaced, kept as it was: a Napi::Number
+ * per property name, numbers truncated to integers, and nested objects and
+ * arrays never released.
+ */
+static obs_data_t *LegacyDataFromObject(Napi::Env env, Napi::Object object, obs_data_t *data = obs_data_create()) {
+  Napi::Array properties = object.GetPropertyNames();
+
+  for (int i = 0, len = properties.Length(); i < len; i++) {
+    Napi::Value key = properties.Get(Napi::Number::New(env, i));
+    Napi::Value value = object.Get(key);
+
+    if (!key.IsString()) continue;
+    std::string keyString = key.ToString();
+
+    if (value.IsString()) {
+      obs_data_set_string(data, keyString.c_str(), value.ToString().Utf8Value().c_str());
+    } else if (value.IsNumber()) {
+      obs_data_set_int(data, keyString.c_str(), value.ToNumber().Int64Value());
+    } else if (value.IsBoolean()) {
+      obs_data_set_bool(data, keyString.c_str(), value.ToBoolean());
+    } else if (value.IsArray()) {
+      obs_data_set_array(data, keyString.c_str(), LegacyArrayFromObject(env, value.As<Napi::Array>()));
+    } else if (value.IsObject()) {
+      obs_data_set_obj(data, keyString.c_str(), LegacyDataFromObject(env, value.ToObject()));
+    }
+  }
+
+  return data;
+}
+
+static obs_data_array_t *LegacyArrayFromObject(Napi::Env env, Napi::Array array) {
+  obs_data_array_t *data = obs_data_array_create();
+  for (int i = 0, len = array.Length(); i < len; i++) {
+    Napi::Value value = array.Get(Napi::Number::New(env, i));
+
+    if (value.IsObject()) {
+      obs_data_array_insert(data, i, LegacyDataFromObject(env, value.ToObject()));
+    }
+  }
+
+  return data;
+}
+
+static bool ParseKind(const std::string &name, SettingsKind &kind) {
+  if (name == "source") kind = SettingsKind::Source;
+  else if (name == "encoder") kind = SettingsKind::Encoder;
+  else if (name == "output") kind = SettingsKind::Output;
+  else if (name == "service") kind = SettingsKind::Service;
+  else return false;
+  return true;
+}
+
+/**
+ * Convert a settings object iterations times with both conversions and
+ * return the nanoseconds each took, and the time SettingsMarshaller took to
+ * build the schema of the type on its first call.
+ *
+ * run(kind: "source" | "encoder" | "output" | "service", id, settings, iterations)
+ */
+Napi::Value SettingsBenchmark::Run(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  SettingsKind kind;
+  if (!info[0].IsString() || !ParseKind(info[0].As<Napi::String>().Utf8Value(), kind)) {
+    Napi::TypeError::New(env, "First argument must be source, encoder, output or service")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!info[1].IsString() || !info[2].IsObject() || !info[3].IsNumber()) {
+    Napi::TypeError::New(env, "Expected a type id, a settings object and a number of iterations")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string id = info[1].As<Napi::String>().Utf8Value();
+  Napi::Object settings = info[2].ToObject();
+  int64_t iterations = info[3].As<Napi::Number>().Int64Value();
+
+  uint64_t start = os_gettime_ns();
+  obs_data_t *first = obs_data_create();
+  SettingsMarshaller::Apply(settings, first, kind, id);
+  obs_data_release(first);
+  uint64_t schemaNs = os_gettime_ns() - start;
+
+  start = os_gettime_ns();
+  for (int64_t i = 0; i < iterations; i++) {
+    obs_data_t *data = obs_data_create();
+    SettingsMarshaller::Apply(settings, data, kind, id);
+    obs_data_release(data);
+  }
+  uint64_t marshallerNs = os_gettime_ns() - start;
+
+  start = os_gettime_ns();
+  for (int64_t i = 0; i < iterations; i++) {
+    obs_data_t *data = LegacyDataFromObject(env, settings);
+    obs_data_release(data);
+  }
+  uint64_t legacyNs = os_gettime_ns() - start;
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("schemaNs", Napi::Number::New(env, static_cast<double>(schemaNs)));
+  result.Set("marshallerNs", Napi::Number::New(env, static_cast<double>(marshallerNs)));
+  result.Set("legacyNs", Napi::Number::New(env, static_cast<double>(legacyNs)));
+  return result;
+}
+
+Napi::Object SettingsBenchmark::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Object benchmarkObject = Napi::Object::New(env);
+  benchmarkObject.Set(Napi::String::New(env, "run"), Napi::Function::New(env, Run));
+
+  exports.Set(Napi::String::New(env, "SettingsBenchmark"), benchmarkObject);
+  return exports;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <napi.h>
+
+/**
+ * Native side of bench/settings-marshaller.js, only built with
+ * OBS_NODE_BENCHMARKS. Times SettingsMarshaller against the generic
+ * DataFromObject conversion it replaced, without the JavaScript call
+ * overhead that would hide the difference.
+ */
+namespace SettingsBenchmark {
+  Napi::Value Run(const Napi::CallbackInfo &info);
+
+  Napi::Object Init(Napi::Env env, Napi::Object exports);
+};
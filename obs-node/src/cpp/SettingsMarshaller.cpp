@@ -0,0 +1,339 @@
+#include "SettingsMarshaller.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+std::unordered_map<std::string, std::unique_ptr<SettingsMarshaller::Schema>> SettingsMarshaller::schemas;
+
+/**
+ * Copy the properties of object into data, using the schema of the OBS type
+ * id of the given kind.
+ */
+void SettingsMarshaller::Apply(Napi::Object object, obs_data_t *data, SettingsKind kind, const std::string &id) {
+  ApplyWithSchema(object, data, GetSchema(kind, id));
+}
+
+/**
+ * Copy the properties of object into data without a schema.
+ */
+void SettingsMarshaller::Apply(Napi::Object object, obs_data_t *data) {
+  ApplyWithSchema(object, data, nullptr);
+}
+
+/**
+ * Read one setting, or its default if it was never set, as a JavaScript
+ * value. Returns undefined for settings that do not exist.
+ */
+Napi::Value SettingsMarshaller::GetValue(Napi::Env env, obs_data_t *data, const char *key) {
+  obs_data_item_t *item = obs_data_item_byname(data, key);
+  if (item == nullptr) return env.Undefined();
+
+  Napi::Value value = env.Undefined();
+  switch (obs_data_item_gettype(item)) {
+    case OBS_DATA_STRING: {
+      const char *string = obs_data_item_get_string(item);
+      value = Napi::String::New(env, string ? string : "");
+      break;
+    }
+    case OBS_DATA_NUMBER:
+      if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+        value = Napi::Number::New(env, static_cast<double>(obs_data_item_get_int(item)));
+      } else {
+        value = Napi::Number::New(env, obs_data_item_get_double(item));
+      }
+      break;
+    case OBS_DATA_BOOLEAN:
+      value = Napi::Boolean::New(env, obs_data_item_get_bool(item));
+      break;
+    case OBS_DATA_OBJECT: {
+      obs_data_t *object = obs_data_item_get_obj(item);
+      if (object != nullptr) {
+        value = ToObject(env, object);
+        obs_data_release(object);
+      }
+      break;
+    }
+    case OBS_DATA_ARRAY: {
+      obs_data_array_t *array = obs_data_item_get_array(item);
+      size_t count = obs_data_array_count(array);
+      Napi::Array elements = Napi::Array::New(env, count);
+
+      for (size_t i = 0; i < count; i++) {
+        obs_data_t *element = obs_data_array_item(array, i);
+        elements.Set(static_cast<uint32_t>(i), ToObject(env, element));
+        obs_data_release(element);
+      }
+      obs_data_array_release(array);
+      value = elements;
+      break;
+    }
+    default:
+      break;
+  }
+
+  obs_data_item_release(&item);
+  return value;
+}
+
+/**
+ * Convert every setting of data into a JavaScript object.
+ */
+Napi::Object SettingsMarshaller::ToObject(Napi::Env env, obs_data_t *data) {
+  Napi::Object object = Napi::Object::New(env);
+
+  for (obs_data_item_t *item = obs_data_first(data); item != nullptr; obs_data_item_next(&item)) {
+    const char *key = obs_data_item_get_name(item);
+    object.Set(key, GetValue(env, data, key));
+  }
+
+  return object;
+}
+
+/**
+ * Convert object into changes, keeping only the settings that differ from
+ * current. Returns whether anything differs.
+ */
+bool SettingsMarshaller::Diff(Napi::Object object, obs_data_t *current, obs_data_t *changes, SettingsKind kind, const std::string &id) {
+  ApplyWithSchema(object, changes, GetSchema(kind, id));
+
+  std::vector<std::string> unchanged;
+  for (obs_data_item_t *item = obs_data_first(changes); item != nullptr; obs_data_item_next(&item)) {
+    const char *key = obs_data_item_get_name(item);
+    obs_data_item_t *existing = obs_data_item_byname(current, key);
+    if (existing == nullptr) continue;
+
+    if (ItemEquals(item, existing)) unchanged.emplace_back(key);
+    obs_data_item_release(&existing);
+  }
+
+  for (const std::string &key : unchanged) {
+    obs_data_erase(changes, key.c_str());
+  }
+
+  obs_data_item_t *first = obs_data_first(changes);
+  if (first == nullptr) return false;
+  obs_data_item_release(&first);
+  return true;
+}
+
+/**
+ * Compare a new setting with the effective value of an existing one, which
+ * is its default if it was never set. Integers and doubles compare by value.
+ */
+bool SettingsMarshaller::ItemEquals(obs_data_item_t *item, obs_data_item_t *existing) {
+  enum obs_data_type type = obs_data_item_gettype(item);
+  if (obs_data_item_gettype(existing) != type) return false;
+
+  switch (type) {
+    case OBS_DATA_STRING: {
+      const char *value = obs_data_item_get_string(item);
+      const char *existingValue = obs_data_item_get_string(existing);
+      return strcmp(value ? value : "", existingValue ? existingValue : "") == 0;
+    }
+    case OBS_DATA_NUMBER:
+      if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT && obs_data_item_numtype(existing) == OBS_DATA_NUM_INT) {
+        return obs_data_item_get_int(item) == obs_data_item_get_int(existing);
+      }
+      return obs_data_item_get_double(item) == obs_data_item_get_double(existing);
+    case OBS_DATA_BOOLEAN:
+      return obs_data_item_get_bool(item) == obs_data_item_get_bool(existing);
+    case OBS_DATA_OBJECT: {
+      obs_data_t *value = obs_data_item_get_obj(item);
+      obs_data_t *existingValue = obs_data_item_get_obj(existing);
+      bool equal = DataEquals(value, existingValue);
+      obs_data_release(value);
+      obs_data_release(existingValue);
+      return equal;
+    }
+    case OBS_DATA_ARRAY: {
+      obs_data_array_t *value = obs_data_item_get_array(item);
+      obs_data_array_t *existingValue = obs_data_item_get_array(existing);
+      size_t count = obs_data_array_count(value);
+      bool equal = count == obs_data_array_count(existingValue);
+
+      for (size_t i = 0; equal && i < count; i++) {
+        obs_data_t *element = obs_data_array_item(value, i);
+        obs_data_t *existingElement = obs_data_array_item(existingValue, i);
+        equal = DataEquals(element, existingElement);
+        obs_data_release(element);
+        obs_data_release(existingElement);
+      }
+
+      obs_data_array_release(value);
+      obs_data_array_release(existingValue);
+      return equal;
+    }
+    default:
+      return false;
+  }
+}
+
+/**
+ * Compare nested settings through their JSON, which OBS caches on the data.
+ */
+bool SettingsMarshaller::DataEquals(obs_data_t *a, obs_data_t *b) {
+  if (a == nullptr || b == nullptr) return a == b;
+  return strcmp(obs_data_get_json(a), obs_data_get_json(b)) == 0;
+}
+
+/**
+ * Get the cached schema of a type, building it on first use. Returns
+ * nullptr if OBS has no properties for the type.
+ */
+const SettingsMarshaller::Schema *SettingsMarshaller::GetSchema(SettingsKind kind, const std::string &id) {
+  std::string key = std::to_string(static_cast<int>(kind)) + ":" + id;
+  auto cached = schemas.find(key);
+  if (cached != schemas.end()) {
+    return cached->second.get();
+  }
+
+  obs_properties_t *properties = nullptr;
+  switch (kind) {
+    case SettingsKind::Source:
+      properties = obs_get_source_properties(id.c_str());
+      break;
+    case SettingsKind::Encoder:
+      properties = obs_get_encoder_properties(id.c_str());
+      break;
+    case SettingsKind::Output:
+      properties = obs_get_output_properties(id.c_str());
+      break;
+    case SettingsKind::Service:
+      properties = obs_get_service_properties(id.c_str());
+      break;
+  }
+
+  // Types without properties are cached as well, so they are only looked up once.
+  std::unique_ptr<Schema> schema;
+  if (properties != nullptr) {
+    schema = std::make_unique<Schema>();
+    AddProperties(*schema, properties);
+    obs_properties_destroy(properties);
+  }
+
+  auto &entry = schemas[key];
+  entry = std::move(schema);
+  return entry.get();
+}
+
+void SettingsMarshaller::AddProperties(Schema &schema, obs_properties_t *properties) {
+  for (obs_property_t *property = obs_properties_first(properties); property != nullptr; obs_property_next(&property)) {
+    if (obs_property_get_type(property) == OBS_PROPERTY_GROUP) {
+      AddProperties(schema, obs_property_group_content(property));
+      continue;
+    }
+
+    ValueType type = GetValueType(property);
+    if (type != ValueType::Unknown) {
+      schema[obs_property_name(property)] = type;
+    }
+  }
+}
+
+/**
+ * Map an OBS property to the type of the setting it edits.
+ */
+SettingsMarshaller::ValueType SettingsMarshaller::GetValueType(obs_property_t *property) {
+  switch (obs_property_get_type(property)) {
+    case OBS_PROPERTY_BOOL:
+      return ValueType::Bool;
+    case OBS_PROPERTY_INT:
+    case OBS_PROPERTY_COLOR:
+      return ValueType::Int;
+    case OBS_PROPERTY_FLOAT:
+      return ValueType::Double;
+    case OBS_PROPERTY_TEXT:
+    case OBS_PROPERTY_PATH:
+      return ValueType::String;
+    case OBS_PROPERTY_FONT:
+      return ValueType::Object;
+    case OBS_PROPERTY_EDITABLE_LIST:
+      return ValueType::Array;
+    case OBS_PROPERTY_LIST:
+      switch (obs_property_list_format(property)) {
+        case OBS_COMBO_FORMAT_INT:
+          return ValueType::Int;
+        case OBS_COMBO_FORMAT_FLOAT:
+          return ValueType::Double;
+        case OBS_COMBO_FORMAT_STRING:
+          return ValueType::String;
+        default:
+          return ValueType::Unknown;
+      }
+    default:
+      return ValueType::Unknown;
+  }
+}
+
+void SettingsMarshaller::ApplyWithSchema(Napi::Object object, obs_data_t *data, const Schema *schema) {
+  Napi::Array properties = object.GetPropertyNames();
+
+  for (uint32_t i = 0, len = properties.Length(); i < len; i++) {
+    Napi::Value key = properties.Get(i);
+    if (!key.IsString()) continue;
+
+    std::string keyString = key.As<Napi::String>().Utf8Value();
+    ValueType type = ValueType::Unknown;
+    if (schema != nullptr) {
+      auto entry = schema->find(keyString);
+      if (entry != schema->end()) type = entry->second;
+    }
+
+    SetValue(data, keyString.c_str(), object.Get(key), type);
+  }
+}
+
+/**
+ * Set one setting. The schema type wins if the value can be converted to
+ * it, otherwise the JavaScript type of the value decides.
+ */
+void SettingsMarshaller::SetValue(obs_data_t *data, const char *key, Napi::Value value, ValueType type) {
+  if (value.IsNumber()) {
+    double number = value.As<Napi::Number>().DoubleValue();
+    if (type == ValueType::Bool) {
+      obs_data_set_bool(data, key, number != 0);
+    } else if (type == ValueType::Double || (type != ValueType::Int && std::trunc(number) != number)) {
+      obs_data_set_double(data, key, number);
+    } else {
+      obs_data_set_int(data, key, static_cast<long long>(number));
+    }
+  } else if (value.IsString()) {
+    obs_data_set_string(data, key, value.As<Napi::String>().Utf8Value().c_str());
+  } else if (value.IsBoolean()) {
+    obs_data_set_bool(data, key, value.As<Napi::Boolean>().Value());
+  } else if (value.IsArray()) {
+    obs_data_array_t *array = ArrayFromValue(value.As<Napi::Array>());
+    obs_data_set_array(data, key, array);
+    obs_data_array_release(array);
+  } else if (value.IsObject()) {
+    obs_data_t *object = obs_data_create();
+    ApplyWithSchema(value.As<Napi::Object>(), object, nullptr);
+    obs_data_set_obj(data, key, object);
+    obs_data_release(object);
+  }
+}
+
+/**
+ * Convert an array of objects into an OBS data array. OBS arrays can only
+ * hold objects, strings become the { value } items of editable lists and
+ * other elements are skipped.
+ */
+obs_data_array_t *SettingsMarshaller::ArrayFromValue(Napi::Array array) {
+  obs_data_array_t *data = obs_data_array_create();
+
+  for (uint32_t i = 0, len = array.Length(); i < len; i++) {
+    Napi::Value value = array.Get(i);
+    if (!value.IsString() && (!value.IsObject() || value.IsArray())) continue;
+
+    obs_data_t *item = obs_data_create();
+    if (value.IsString()) {
+      obs_data_set_string(item, "value", value.As<Napi::String>().Utf8Value().c_str());
+    } else {
+      ApplyWithSchema(value.As<Napi::Object>(), item, nullptr);
+    }
+    obs_data_array_push_back(data, item);
+    obs_data_release(item);
+  }
+
+  return data;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <napi.h>
+#include <obs.h>
+
+/**
+ * The kinds of OBS objects settings are converted for, each has its own
+ * property namespace.
+ */
+enum class SettingsKind { Source, Encoder, Output, Service };
+
+/**
+ * Converts Node.js objects into OBS settings.
+ *
+ * The type of every property is looked up in a schema built once per kind
+ * and type ID from the object's OBS properties, so values are set with the
+ * setter OBS expects. Properties without a schema entry fall back to the
+ * type of the JavaScript value, numbers with a fractional part are kept as
+ * doubles. Nested objects and arrays are released once they have been set.
+ * Single settings can be read back without serializing the whole object.
+ */
+class SettingsMarshaller {
+public:
+  static void Apply(Napi::Object object, obs_data_t *data, SettingsKind kind, const std::string &id);
+  static void Apply(Napi::Object object, obs_data_t *data);
+  static Napi::Value GetValue(Napi::Env env, obs_data_t *data, const char *key);
+  static Napi::Object ToObject(Napi::Env env, obs_data_t *data);
+  static bool Diff(Napi::Object object, obs_data_t *current, obs_data_t *changes, SettingsKind kind, const std::string &id);
+
+private:
+  enum class ValueType { Unknown, Bool, Int, Double, String, Array, Object };
+  using Schema = std::unordered_map<std::string, ValueType>;
+
+  static const Schema *GetSchema(SettingsKind kind, const std::string &id);
+  static void AddProperties(Schema &schema, obs_properties_t *properties);
+  static ValueType GetValueType(obs_property_t *property);
+
+  static void ApplyWithSchema(Napi::Object object, obs_data_t *data, const Schema *schema);
+  static void SetValue(obs_data_t *data, const char *key, Napi::Value value, ValueType type);
+  static obs_data_array_t *ArrayFromValue(Napi::Array array);
+  static bool ItemEquals(obs_data_item_t *item, obs_data_item_t *existing);
+  static bool DataEquals(obs_data_t *a, obs_data_t *b);
+
+  static std::unordered_map<std::string, std::unique_ptr<Schema>> schemas;
+};
@@ -0,0 +1,209 @@
+#include "SignalDispatcher.h"
+#include "EventBus.h"
+#include <cstring>
+
+// Signal names in the order of ObsSignal.
+static const char *signalNames[] = {
+  "destroy", "remove", "activate", "deactivate", "show", "hide", "mute", "enable", "rename",
+  "volume", "audio_sync", "audio_mixers", "update_properties", "update_flags",
+  "filter_add", "filter_remove", "reorder_filters",
+  "transition_start", "transition_video_stop", "transition_stop",
+  "media_play", "media_pause", "media_restart", "media_stopped", "media_next", "media_previous", "media_started", "media_ended",
+  "item_add", "item_remove", "reorder", "refresh", "item_visible", "item_locked", "item_select", "item_deselect", "item_transform",
+  "start", "stop", "starting", "stopping", "reconnect", "reconnect_success",
+};
+
+static_assert(sizeof(signalNames) / sizeof(signalNames[0]) == static_cast<size_t>(ObsSignal::Count),
+              "Every ObsSignal needs a name");
+static_assert(static_cast<size_t>(ObsSignal::Count) <= 64, "Subscriptions are a 64 bit mask");
+
+static std::atomic<uint32_t> nextHandle{1};
+
+SignalDispatcher::SignalDispatcher() {
+  handle = nextHandle++;
+}
+
+/**
+ * Start forwarding the signals of a signal handler.
+ */
+void SignalDispatcher::Connect(signal_handler_t *signalHandler) {
+  Disconnect();
+  handler = signalHandler;
+  signal_handler_connect_global(handler, &OnSignal, this);
+}
+
+/**
+ * Stop forwarding signals. Disconnecting waits for signals being emitted
+ * right now, so the dispatcher can be deleted afterwards.
+ */
+void SignalDispatcher::Disconnect() {
+  if (handler != nullptr) {
+    signal_handler_disconnect_global(handler, &OnSignal, this);
+    handler = nullptr;
+  }
+}
+
+/**
+ * Forward a signal from now on. Returns false for unknown signal names.
+ */
+bool SignalDispatcher::Subscribe(const std::string &name) {
+  ObsSignal signal;
+  if (!FindSignal(name.c_str(), signal)) return false;
+
+  subscriptions |= uint64_t(1) << static_cast<uint8_t>(signal);
+  return true;
+}
+
+/**
+ * Stop forwarding a signal. Returns false for unknown signal names.
+ */
+bool SignalDispatcher::Unsubscribe(const std::string &name) {
+  ObsSignal signal;
+  if (!FindSignal(name.c_str(), signal)) return false;
+
+  subscriptions &= ~(uint64_t(1) << static_cast<uint8_t>(signal));
+  return true;
+}
+
+/**
+ * Subscribe to or unsubscribe from every signal in an array of names passed
+ * in from Node.js. Throws a TypeError and returns false if the array is
+ * invalid or contains an unknown signal.
+ */
+bool SignalDispatcher::UpdateSubscriptions(Napi::Env env, Napi::Value names, bool subscribe) {
+  if (!names.IsArray()) {
+    Napi::TypeError::New(env, "First argument must be an array of signal names")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  auto array = names.As<Napi::Array>();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    std::string name = array.Get(i).ToString().Utf8Value();
+    if (!(subscribe ? Subscribe(name) : Unsubscribe(name))) {
+      Napi::TypeError::New(env, "Unknown signal " + name)
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Get the handle events from this dispatcher are tagged with.
+ */
+uint32_t SignalDispatcher::GetHandle() const {
+  return handle;
+}
+
+const char *SignalDispatcher::GetSignalName(ObsSignal signal) {
+  return signalNames[static_cast<size_t>(signal)];
+}
+
+bool SignalDispatcher::FindSignal(const char *name, ObsSignal &signal) {
+  for (size_t i = 0; i < static_cast<size_t>(ObsSignal::Count); i++) {
+    if (strcmp(signalNames[i], name) == 0) {
+      signal = static_cast<ObsSignal>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Global signal callback, called on whichever thread emitted the signal.
+ * The calldata is only valid during this call, so the payload is decoded
+ * into the event right away.
+ */
+void SignalDispatcher::OnSignal(void *data, const char *name, calldata_t *cd) {
+  auto dispatcher = static_cast<SignalDispatcher *>(data);
+  uint64_t subscriptions = dispatcher->subscriptions;
+  if (subscriptions == 0) return;
+
+  SignalEvent event;
+  if (!FindSignal(name, event.signal) || !(subscriptions & (uint64_t(1) << static_cast<uint8_t>(event.signal)))) return;
+
+  event.handle = dispatcher->handle;
+  Decode(event, cd);
+  EventBus::Post(event);
+}
+
+/**
+ * Copy the payload of a signal into an event.
+ */
+void SignalDispatcher::Decode(SignalEvent &event, calldata_t *cd) {
+  event.payload = SignalEvent::Payload::None;
+  event.number = 0;
+  event.text[0] = '\0';
+  event.hasState = false;
+  event.state = false;
+
+  auto setBoolean = [&](const char *name) {
+    event.payload = SignalEvent::Payload::Boolean;
+    event.number = calldata_bool(cd, name) ? 1 : 0;
+  };
+  auto setNumber = [&](double value) {
+    event.payload = SignalEvent::Payload::Number;
+    event.number = value;
+  };
+  auto setText = [&](const char *text) {
+    event.payload = SignalEvent::Payload::String;
+    strncpy(event.text, text != nullptr ? text : "", sizeof(event.text) - 1);
+    event.text[sizeof(event.text) - 1] = '\0';
+  };
+
+  switch (event.signal) {
+    case ObsSignal::Mute:
+      setBoolean("muted");
+      break;
+    case ObsSignal::Enable:
+      setBoolean("enabled");
+      break;
+    case ObsSignal::Rename:
+      setText(calldata_string(cd, "new_name"));
+      break;
+    case ObsSignal::Volume:
+      setNumber(calldata_float(cd, "volume"));
+      break;
+    case ObsSignal::AudioSync:
+      setNumber((double)calldata_int(cd, "offset"));
+      break;
+    case ObsSignal::AudioMixers:
+      setNumber((double)calldata_int(cd, "mixers"));
+      break;
+    case ObsSignal::UpdateFlags:
+      setNumber((double)calldata_int(cd, "flags"));
+      break;
+    case ObsSignal::Stop:
+      setNumber((double)calldata_int(cd, "code"));
+      break;
+    case ObsSignal::Reconnect:
+      setNumber((double)calldata_int(cd, "timeout_sec"));
+      break;
+    case ObsSignal::FilterAdd:
+    case ObsSignal::FilterRemove: {
+      auto filter = static_cast<obs_source_t *>(calldata_ptr(cd, "filter"));
+      setText(filter != nullptr ? obs_source_get_name(filter) : nullptr);
+      break;
+    }
+    case ObsSignal::ItemAdd:
+    case ObsSignal::ItemRemove:
+    case ObsSignal::ItemSelect:
+    case ObsSignal::ItemDeselect:
+    case ObsSignal::ItemTransform:
+    case ObsSignal::ItemVisible:
+    case ObsSignal::ItemLocked: {
+      // Scene item signals carry the ID of the item.
+      auto item = static_cast<obs_sceneitem_t *>(calldata_ptr(cd, "item"));
+      setNumber(item != nullptr ? (double)obs_sceneitem_get_id(item) : -1);
+      if (event.signal == ObsSignal::ItemVisible || event.signal == ObsSignal::ItemLocked) {
+        event.hasState = true;
+        event.state = calldata_bool(cd, event.signal == ObsSignal::ItemVisible ? "visible" : "locked");
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
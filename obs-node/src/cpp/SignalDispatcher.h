@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <napi.h>
+#include <obs.h>
+
+/**
+ * The libobs source, scene and output signals that can be subscribed to
+ * from Node.js. The value of each signal is its bit in a subscription mask.
+ */
+enum class ObsSignal : uint8_t {
+  Destroy, Remove, Activate, Deactivate, Show, Hide, Mute, Enable, Rename,
+  Volume, AudioSync, AudioMixers, UpdateProperties, UpdateFlags,
+  FilterAdd, FilterRemove, ReorderFilters,
+  TransitionStart, TransitionVideoStop, TransitionStop,
+  MediaPlay, MediaPause, MediaRestart, MediaStopped, MediaNext, MediaPrevious, MediaStarted, MediaEnded,
+  ItemAdd, ItemRemove, Reorder, Refresh, ItemVisible, ItemLocked, ItemSelect, ItemDeselect, ItemTransform,
+  Start, Stop, Starting, Stopping, Reconnect, ReconnectSuccess,
+  Count
+};
+
+/**
+ * A decoded signal on its way to Node.js, tagged with the handle of the
+ * object that emitted it.
+ */
+struct SignalEvent {
+  enum class Payload : uint8_t { None, Boolean, Number, String };
+
+  uint32_t handle;
+  ObsSignal signal;
+  Payload payload;
+  double number;
+  char text[256];
+  // Scene item visibility and lock changes carry the new state as well as the item ID.
+  bool hasState;
+  bool state;
+};
+
+/**
+ * Forwards the libobs signals of one source, scene or output to the
+ * EventBus under a handle unique to this dispatcher.
+ *
+ * Only signals in the subscription mask are forwarded, everything else is
+ * filtered on the thread that emitted it. Forwarded signals have their
+ * payload decoded while the calldata is still valid. The owner must
+ * disconnect the dispatcher before deleting it.
+ */
+class SignalDispatcher {
+public:
+  SignalDispatcher();
+
+  void Connect(signal_handler_t *handler);
+  void Disconnect();
+
+  bool Subscribe(const std::string &name);
+  bool Unsubscribe(const std::string &name);
+  bool UpdateSubscriptions(Napi::Env env, Napi::Value names, bool subscribe);
+
+  uint32_t GetHandle() const;
+
+  static const char *GetSignalName(ObsSignal signal);
+  static bool FindSignal(const char *name, ObsSignal &signal);
+
+private:
+  static void OnSignal(void *data, const char *name, calldata_t *cd);
+  static void Decode(SignalEvent &event, calldata_t *cd);
+
+  uint32_t handle;
+  signal_handler_t *handler = nullptr;
+  std::atomic<uint64_t> subscriptions{0};
+};
@@ -1,8 +1,21 @@
 #include "Source.h"
+#include <unordered_map>
+#include <vector>
 
 Source::Source(const Napi::CallbackInfo &info) : ObjectWrap(info) {
   Napi::Env env = info.Env();
 
+  // Wrap an existing source, see FromReference.
+  if (info[0].IsExternal()) {
+    sourceReference = info[0].As<Napi::External<obs_source_t>>().Data();
+    obs_source_addref(sourceReference);
+    sourceType = obs_source_get_id(sourceReference);
+    name = obs_source_get_name(sourceReference);
+    SetupSignalHandler();
+    SetupMediaCache();
+    return;
+  }
+
   if (info.Length() < 2) {
     Napi::TypeError::New(env, "Wrong number of arguments")
         .ThrowAsJavaScriptException();
@@ -15,27 +28,18 @@ Source::Source(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  if (!info[2].IsFunction() && !info[2].IsNull() && !info[2].IsUndefined()) {
-    Napi::TypeError::New(env, "Third argument must be a function or null")
-        .ThrowAsJavaScriptException();
-    return;
-  }
-
-  if (!info[3].IsUndefined() && !info[3].IsNull() && !info[3].IsObject()) {
-    Napi::TypeError::New(env, "Fourth argument must be an object or null")
+  if (!info[2].IsUndefined() && !info[2].IsNull() && !info[2].IsObject()) {
+    Napi::TypeError::New(env, "Third argument must be an object or null")
         .ThrowAsJavaScriptException();
     return;
   }
 
   sourceType = info[0].ToString().Utf8Value();
   name = info[1].ToString().Utf8Value();
-  if (sourceType == "scene") {
-    if (info[2].IsFunction()) {
-      signalHandler = Napi::ThreadSafeFunction::New(
-          env, info[2].As<Napi::Function>(), "Source Signal Handler", 0, 1);
 
-      return;
-    }
+  // Scenes wrap the source of an existing scene, see Scene::AsSource.
+  if (sourceType == "scene") {
+    return;
   }
 
   obs_data_t *settings = obs_get_source_defaults(sourceType.c_str());
@@ -46,11 +50,12 @@ Source::Source(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  if (info[3].IsObject()) {
-    DataFromObject(env, info[3].ToObject(), settings);
+  if (info[2].IsObject()) {
+    SettingsMarshaller::Apply(info[2].ToObject(), settings, SettingsKind::Source, sourceType);
   }
 
-  sourceReference = obs_source_create(sourceType.c_str(), name.c_str(), nullptr, nullptr);
+  sourceReference = obs_source_create(sourceType.c_str(), name.c_str(), settings, nullptr);
+  obs_data_release(settings);
 
   if (sourceReference == nullptr) {
     Napi::TypeError::New(env, "Could not create source object")
@@ -58,42 +63,107 @@ Source::Source(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  obs_source_update(sourceReference, settings);
   obs_source_set_audio_mixers(sourceReference, 1);
-  if (info[2].IsFunction()) {
-    signalHandler = Napi::ThreadSafeFunction::New(
-        env, info[2].As<Napi::Function>(), "Source Signal Handler", 0, 1);
+  SetupSignalHandler();
+  SetupMediaCache();
+}
 
-    SetupSignalHandler();
-  }
+Napi::FunctionReference Source::constructor;
+
+/**
+ * Create a Source object holding a new reference to an existing source.
+ */
+Napi::Object Source::FromReference(Napi::Env env, obs_source_t *source) {
+  return constructor.New({Napi::External<obs_source_t>::New(env, source)});
 }
 
+/**
+ * Forward the signals of this source that Node.js subscribed to to the
+ * event bus. Nothing is forwarded until subscribe is called.
+ */
 void Source::SetupSignalHandler() {
-  if (!signalHandler) return;
-
-  sourceSignalHandler = obs_source_get_signal_handler(sourceReference);
-  signal_handler_connect_global(
-      sourceSignalHandler,
-      [](void *sourceData, const char *signalName, calldata_t *signalData) {
-        auto source = reinterpret_cast<Source *>(sourceData);
-        auto signal = new struct signal();
-        signal->name = signalName;
-        signal->data = signalData;
-
-        source->signalHandler.BlockingCall(
-            signal, [](Napi::Env env, Napi::Function jsCallback,
-                       struct signal *data) {
-              jsCallback.Call({Napi::String::New(env, data->name)});
-              delete data;
-            });
-      },
-      this);
+  if (sourceReference == nullptr) return;
+
+  signals.Connect(obs_source_get_signal_handler(sourceReference));
+}
+
+/**
+ * Cache the position, duration and state of controllable media sources
+ * every frame, so polling them from Node.js does not call into the decoder.
+ */
+void Source::SetupMediaCache() {
+  if ((obs_source_get_output_flags(sourceReference) & OBS_SOURCE_CONTROLLABLE_MEDIA) == 0) return;
+
+  obs_add_tick_callback(&Source::MediaTick, this);
+  mediaCached = true;
+}
+
+void Source::MediaTick(void *param, [[maybe_unused]] float seconds) {
+  auto *source = static_cast<Source *>(param);
+
+  source->mediaTime = obs_source_media_get_time(source->sourceReference);
+  source->mediaDuration = obs_source_media_get_duration(source->sourceReference);
+  source->mediaState = obs_source_media_get_state(source->sourceReference);
 }
 
 Source::~Source() {
+  // Disconnect before the source can go away.
+  signals.Disconnect();
+  if (mediaCached && obs_initialized()) obs_remove_tick_callback(&Source::MediaTick, this);
   if (sourceReference != nullptr) obs_source_release(sourceReference);
 }
 
+/**
+ * Stop using the source and hand the reference this object holds to the
+ * caller. The object no longer controls a source afterwards.
+ */
+obs_source_t *Source::Detach() {
+  signals.Disconnect();
+  if (mediaCached) {
+    obs_remove_tick_callback(&Source::MediaTick, this);
+    mediaCached = false;
+  }
+
+  obs_source_t *source = sourceReference;
+  sourceReference = nullptr;
+  return source;
+}
+
+/**
+ * Get the handle the events of this source are tagged with on the event bus.
+ */
+Napi::Value Source::GetHandle(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, signals.GetHandle());
+}
+
+/**
+ * Start forwarding the signals named in the array passed in.
+ */
+Napi::Value Source::Subscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  signals.UpdateSubscriptions(env, info[0], true);
+  return env.Null();
+}
+
+/**
+ * Stop forwarding the signals named in the array passed in.
+ */
+Napi::Value Source::Unsubscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  signals.UpdateSubscriptions(env, info[0], false);
+  return env.Null();
+}
+
+/**
+ * Apply the settings that differ from the current ones. Media sources are
+ * reopened by every update, so an update is skipped if nothing changed, and
+ * resubmitting the current media restarts it instead of reopening it.
+ * Returns "update", "restart" or "none".
+ */
 Napi::Value Source::UpdateSettings(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -111,19 +181,62 @@ Napi::Value Source::UpdateSettings(const Napi::CallbackInfo &info) {
     return env.Null();
   }
 
-  DataFromObject(env, info[0].ToObject(), settings);
+  Napi::Object object = info[0].ToObject();
+  obs_data_t *changes = obs_data_create();
+  bool changed = SettingsMarshaller::Diff(object, settings, changes, SettingsKind::Source, sourceType);
+
+  const char *result = "none";
+  if (changed) {
+    // libobs merges the changes into the current settings.
+    obs_source_update(sourceReference, changes);
+    result = "update";
+  } else if (NamesCurrentMedia(object)) {
+    obs_source_media_restart(sourceReference);
+    mediaTime = 0;
+    result = "restart";
+  }
 
-  obs_source_update(sourceReference, settings);
-  return env.Null();
+  obs_data_release(changes);
+  obs_data_release(settings);
+  return Napi::String::New(env, result);
 }
 
+/**
+ * Whether the settings name the media a controllable media source plays,
+ * as a non-empty input, file or playlist.
+ */
+bool Source::NamesCurrentMedia(Napi::Object object) {
+  static const std::unordered_map<std::string, std::vector<const char *>> mediaKeys = {
+      {"ffmpeg_source", {"input", "local_file"}},
+      {"vlc_source", {"playlist"}},
+  };
+
+  if ((obs_source_get_output_flags(sourceReference) & OBS_SOURCE_CONTROLLABLE_MEDIA) == 0) return false;
+
+  auto keys = mediaKeys.find(sourceType);
+  if (keys == mediaKeys.end()) return false;
+
+  for (const char *key : keys->second) {
+    Napi::Value value = object.Get(key);
+    if (value.IsString() && !value.As<Napi::String>().Utf8Value().empty()) return true;
+    if (value.IsArray() && value.As<Napi::Array>().Length() > 0) return true;
+  }
+
+  return false;
+}
+
+/**
+ * Get the settings of the source as an object, converted natively instead
+ * of through JSON.
+ */
 Napi::Value Source::GetSettings(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   obs_data_t *settings = obs_source_get_settings(sourceReference);
-  const char *json = obs_data_get_json(settings);
+  Napi::Object object = SettingsMarshaller::ToObject(env, settings);
+  obs_data_release(settings);
 
-  return Napi::String::New(env, json);
+  return object;
 }
 
 Napi::Value Source::StartTransition(const Napi::CallbackInfo &info) {
@@ -179,6 +292,448 @@ Napi::Value Source::AssignOutputChannel(const Napi::CallbackInfo &info) {
   return env.Null();
 }
 
+/**
+ * Pause the media if the argument is true, otherwise resume it.
+ */
+Napi::Value Source::PlayPause(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "First argument must be a boolean")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_media_play_pause(sourceReference, info[0].As<Napi::Boolean>().Value());
+  return env.Null();
+}
+
+/**
+ * Play the media from the start without reopening it.
+ */
+Napi::Value Source::Restart(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  obs_source_media_restart(sourceReference);
+  mediaTime = 0;
+  return env.Null();
+}
+
+Napi::Value Source::Stop(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  obs_source_media_stop(sourceReference);
+  return env.Null();
+}
+
+/**
+ * Seek to the position in milliseconds passed in.
+ */
+Napi::Value Source::SetTime(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  int64_t ms = info[0].As<Napi::Number>().Int64Value();
+  obs_source_media_set_time(sourceReference, ms);
+  // Report the new position until the next frame refreshes it.
+  mediaTime = ms;
+  return env.Null();
+}
+
+/**
+ * Get the position of the media in milliseconds as of the last frame.
+ */
+Napi::Value Source::GetTime(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, static_cast<double>(mediaTime.load()));
+}
+
+/**
+ * Get the duration of the media in milliseconds as of the last frame.
+ */
+Napi::Value Source::GetDuration(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, static_cast<double>(mediaDuration.load()));
+}
+
+/**
+ * Get the state of the media as of the last frame.
+ */
+Napi::Value Source::GetState(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::String::New(env, GetMediaStateName(mediaState));
+}
+
+const char *Source::GetMediaStateName(int state) {
+  switch (state) {
+    case OBS_MEDIA_STATE_PLAYING:
+      return "playing";
+    case OBS_MEDIA_STATE_OPENING:
+      return "opening";
+    case OBS_MEDIA_STATE_BUFFERING:
+      return "buffering";
+    case OBS_MEDIA_STATE_PAUSED:
+      return "paused";
+    case OBS_MEDIA_STATE_STOPPED:
+      return "stopped";
+    case OBS_MEDIA_STATE_ENDED:
+      return "ended";
+    case OBS_MEDIA_STATE_ERROR:
+      return "error";
+    default:
+      return "none";
+  }
+}
+
+/**
+ * Get the size, visibility, media and audio state of the source and the
+ * settings named in the array passed in, in one call. If an object is
+ * passed as second argument it is filled and returned instead of a new
+ * one, so a polling loop can reuse it.
+ */
+Napi::Value Source::GetInfo(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsUndefined() && !info[0].IsNull() && !info[0].IsArray()) {
+    Napi::TypeError::New(env, "First argument must be an array of settings names")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object result = info[1].IsObject() ? info[1].ToObject() : Napi::Object::New(env);
+
+  result.Set("width", Napi::Number::New(env, obs_source_get_width(sourceReference)));
+  result.Set("height", Napi::Number::New(env, obs_source_get_height(sourceReference)));
+  result.Set("active", Napi::Boolean::New(env, obs_source_active(sourceReference)));
+  result.Set("showing", Napi::Boolean::New(env, obs_source_showing(sourceReference)));
+  result.Set("mediaState", Napi::String::New(env, GetMediaStateName(mediaState)));
+  result.Set("mediaTime", Napi::Number::New(env, static_cast<double>(mediaTime.load())));
+  result.Set("mediaDuration", Napi::Number::New(env, static_cast<double>(mediaDuration.load())));
+  result.Set("volume", Napi::Number::New(env, obs_source_get_volume(sourceReference)));
+  result.Set("muted", Napi::Boolean::New(env, obs_source_muted(sourceReference)));
+
+  if (info[0].IsArray()) {
+    Napi::Array keys = info[0].As<Napi::Array>();
+    Napi::Value existing = result.Get("settings");
+    Napi::Object values = existing.IsObject() ? existing.ToObject() : Napi::Object::New(env);
+
+    obs_data_t *settings = obs_source_get_settings(sourceReference);
+    for (uint32_t i = 0, len = keys.Length(); i < len; i++) {
+      Napi::Value key = keys.Get(i);
+      if (!key.IsString()) continue;
+
+      values.Set(key, SettingsMarshaller::GetValue(env, settings, key.As<Napi::String>().Utf8Value().c_str()));
+    }
+    obs_data_release(settings);
+
+    result.Set("settings", values);
+  }
+
+  return result;
+}
+
+/**
+ * Set the volume of the source as a linear multiplier, applied by the OBS
+ * audio mixer.
+ */
+Napi::Value Source::SetVolume(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber() || info[0].As<Napi::Number>().FloatValue() < 0) {
+    Napi::TypeError::New(env, "First argument must be a non-negative number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_set_volume(sourceReference, info[0].As<Napi::Number>().FloatValue());
+  return env.Null();
+}
+
+Napi::Value Source::GetVolume(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, obs_source_get_volume(sourceReference));
+}
+
+Napi::Value Source::SetMuted(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "First argument must be a boolean")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_set_muted(sourceReference, info[0].As<Napi::Boolean>().Value());
+  return env.Null();
+}
+
+Napi::Value Source::IsMuted(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Boolean::New(env, obs_source_muted(sourceReference));
+}
+
+/**
+ * Set the stereo balance, from 0 (left) over 0.5 (center) to 1 (right).
+ */
+Napi::Value Source::SetBalance(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  float balance = info[0].As<Napi::Number>().FloatValue();
+  if (balance < 0.0f || balance > 1.0f) {
+    Napi::RangeError::New(env, "Balance must be between 0 and 1")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_set_balance_value(sourceReference, balance);
+  return env.Null();
+}
+
+Napi::Value Source::GetBalance(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, obs_source_get_balance_value(sourceReference));
+}
+
+/**
+ * Set the audio sync offset in milliseconds, positive values delay the audio.
+ */
+Napi::Value Source::SetSyncOffset(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_set_sync_offset(sourceReference, info[0].As<Napi::Number>().Int64Value() * 1000000);
+  return env.Null();
+}
+
+Napi::Value Source::GetSyncOffset(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, static_cast<double>(obs_source_get_sync_offset(sourceReference) / 1000000));
+}
+
+/**
+ * Set the mask of the audio mixes the source is mixed into, bit 0 being the
+ * first mix. Sources start in the first mix only.
+ */
+Napi::Value Source::SetAudioMixers(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_set_audio_mixers(sourceReference, info[0].As<Napi::Number>().Uint32Value());
+  return env.Null();
+}
+
+Napi::Value Source::GetAudioMixers(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, obs_source_get_audio_mixers(sourceReference));
+}
+
+/**
+ * Enable or disable the source. Disabled filters are skipped.
+ */
+Napi::Value Source::SetEnabled(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "First argument must be a boolean")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_set_enabled(sourceReference, info[0].As<Napi::Boolean>().Value());
+  return env.Null();
+}
+
+Napi::Value Source::IsEnabled(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Boolean::New(env, obs_source_enabled(sourceReference));
+}
+
+/**
+ * Create a filter of the type, name and settings passed in and add it to
+ * the end of the filter chain. Returns the filter as a Source object.
+ */
+Napi::Value Source::AddFilter(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "First two arguments must be strings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!info[2].IsUndefined() && !info[2].IsNull() && !info[2].IsObject()) {
+    Napi::TypeError::New(env, "Third argument must be an object or null")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string filterType = info[0].ToString().Utf8Value();
+  std::string filterName = info[1].ToString().Utf8Value();
+
+  obs_source_t *existing = obs_source_get_filter_by_name(sourceReference, filterName.c_str());
+  if (existing != nullptr) {
+    obs_source_release(existing);
+    Napi::TypeError::New(env, "A filter with this name already exists")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_data_t *settings = obs_get_source_defaults(filterType.c_str());
+
+  if (settings == nullptr) {
+    Napi::TypeError::New(env, "Could not get filter default settings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (info[2].IsObject()) {
+    SettingsMarshaller::Apply(info[2].ToObject(), settings, SettingsKind::Source, filterType);
+  }
+
+  obs_source_t *filter = obs_source_create_private(filterType.c_str(), filterName.c_str(), settings);
+  obs_data_release(settings);
+
+  if (filter == nullptr || obs_source_get_type(filter) != OBS_SOURCE_TYPE_FILTER) {
+    obs_source_release(filter);
+    Napi::TypeError::New(env, "Could not create filter object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_filter_add(sourceReference, filter);
+  Napi::Object object = FromReference(env, filter);
+  // The source and the Source object hold their own references.
+  obs_source_release(filter);
+  return object;
+}
+
+/**
+ * Remove the filter with the name passed in. Returns whether it existed.
+ */
+Napi::Value Source::RemoveFilter(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *filter = obs_source_get_filter_by_name(sourceReference, info[0].ToString().Utf8Value().c_str());
+  if (filter == nullptr) return Napi::Boolean::New(env, false);
+
+  obs_source_filter_remove(sourceReference, filter);
+  obs_source_release(filter);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Get the filter with the name passed in as a Source object, or null.
+ */
+Napi::Value Source::GetFilter(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *filter = obs_source_get_filter_by_name(sourceReference, info[0].ToString().Utf8Value().c_str());
+  if (filter == nullptr) return env.Null();
+
+  Napi::Object object = FromReference(env, filter);
+  obs_source_release(filter);
+  return object;
+}
+
+/**
+ * Get the names of the filters in the order they are applied.
+ */
+Napi::Value Source::GetFilters(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::vector<std::string> names;
+  obs_source_enum_filters(sourceReference, []([[maybe_unused]] obs_source_t *parent, obs_source_t *filter, void *param) {
+    static_cast<std::vector<std::string> *>(param)->emplace_back(obs_source_get_name(filter));
+  }, &names);
+
+  Napi::Array array = Napi::Array::New(env, names.size());
+  for (uint32_t i = 0; i < names.size(); i++) {
+    array.Set(i, Napi::String::New(env, names[i]));
+  }
+  return array;
+}
+
+/**
+ * Move the filter with the name passed in "up", "down", to the "top" or to
+ * the "bottom" of the filter chain.
+ */
+Napi::Value Source::SetFilterOrder(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "First two arguments must be strings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  static const std::unordered_map<std::string, obs_order_movement> movements = {
+      {"up", OBS_ORDER_MOVE_UP},
+      {"down", OBS_ORDER_MOVE_DOWN},
+      {"top", OBS_ORDER_MOVE_TOP},
+      {"bottom", OBS_ORDER_MOVE_BOTTOM},
+  };
+
+  auto movement = movements.find(info[1].ToString().Utf8Value());
+  if (movement == movements.end()) {
+    Napi::TypeError::New(env, "Second argument must be up, down, top or bottom")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *filter = obs_source_get_filter_by_name(sourceReference, info[0].ToString().Utf8Value().c_str());
+  if (filter == nullptr) {
+    Napi::TypeError::New(env, "No filter with this name")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_filter_set_order(sourceReference, filter, movement->second);
+  obs_source_release(filter);
+  return env.Null();
+}
+
 Napi::Value Source::GetHeight(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -198,11 +753,43 @@ Napi::Function Source::GetClass(Napi::Env env) {
       Source::InstanceMethod("startTransition", &Source::StartTransition),
       Source::InstanceMethod("assignOutputChannel", &Source::AssignOutputChannel),
       Source::InstanceMethod("getHeight", &Source::GetHeight),
-      Source::InstanceMethod("getWidth", &Source::GetWidth)
+      Source::InstanceMethod("getWidth", &Source::GetWidth),
+      Source::InstanceMethod("subscribe", &Source::Subscribe),
+      Source::InstanceMethod("unsubscribe", &Source::Unsubscribe),
+      Source::InstanceMethod("getHandle", &Source::GetHandle),
+      Source::InstanceMethod("playPause", &Source::PlayPause),
+      Source::InstanceMethod("restart", &Source::Restart),
+      Source::InstanceMethod("stop", &Source::Stop),
+      Source::InstanceMethod("setTime", &Source::SetTime),
+      Source::InstanceMethod("getTime", &Source::GetTime),
+      Source::InstanceMethod("getDuration", &Source::GetDuration),
+      Source::InstanceMethod("getState", &Source::GetState),
+      Source::InstanceMethod("getInfo", &Source::GetInfo),
+      Source::InstanceMethod("setVolume", &Source::SetVolume),
+      Source::InstanceMethod("getVolume", &Source::GetVolume),
+      Source::InstanceMethod("setMuted", &Source::SetMuted),
+      Source::InstanceMethod("isMuted", &Source::IsMuted),
+      Source::InstanceMethod("setBalance", &Source::SetBalance),
+      Source::InstanceMethod("getBalance", &Source::GetBalance),
+      Source::InstanceMethod("setSyncOffset", &Source::SetSyncOffset),
+      Source::InstanceMethod("getSyncOffset", &Source::GetSyncOffset),
+      Source::InstanceMethod("setAudioMixers", &Source::SetAudioMixers),
+      Source::InstanceMethod("getAudioMixers", &Source::GetAudioMixers),
+      Source::InstanceMethod("setEnabled", &Source::SetEnabled),
+      Source::InstanceMethod("isEnabled", &Source::IsEnabled),
+      Source::InstanceMethod("addFilter", &Source::AddFilter),
+      Source::InstanceMethod("removeFilter", &Source::RemoveFilter),
+      Source::InstanceMethod("getFilter", &Source::GetFilter),
+      Source::InstanceMethod("getFilters", &Source::GetFilters),
+      Source::InstanceMethod("setFilterOrder", &Source::SetFilterOrder)
   });
 }
 
 Napi::Object Source::Init(Napi::Env env, Napi::Object exports) {
-  exports.Set(Napi::String::New(env, "Source"), GetClass(env));
+  if (constructor.IsEmpty()) {
+    constructor = Napi::Persistent(GetClass(env));
+    napi_add_env_cleanup_hook(env, [](void *) { constructor.Reset(); }, nullptr);
+  }
+  exports.Set(Napi::String::New(env, "Source"), constructor.Value());
   return exports;
 }
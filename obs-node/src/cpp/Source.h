@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <obs.h>
 #include <napi.h>
+#include "SignalDispatcher.h"
+#include "SettingsMarshaller.h"
 #include "utils.h"
 class Source: public Napi::ObjectWrap<Source> {
 public:
@@ -16,15 +19,59 @@ public:
   Napi::Value AssignOutputChannel(const Napi::CallbackInfo &info);
   Napi::Value GetHeight(const Napi::CallbackInfo &info);
   Napi::Value GetWidth(const Napi::CallbackInfo &info);
+  Napi::Value Subscribe(const Napi::CallbackInfo &info);
+  Napi::Value Unsubscribe(const Napi::CallbackInfo &info);
+  Napi::Value GetHandle(const Napi::CallbackInfo &info);
+  Napi::Value PlayPause(const Napi::CallbackInfo &info);
+  Napi::Value Restart(const Napi::CallbackInfo &info);
+  Napi::Value Stop(const Napi::CallbackInfo &info);
+  Napi::Value SetTime(const Napi::CallbackInfo &info);
+  Napi::Value GetTime(const Napi::CallbackInfo &info);
+  Napi::Value GetDuration(const Napi::CallbackInfo &info);
+  Napi::Value GetState(const Napi::CallbackInfo &info);
+  Napi::Value GetInfo(const Napi::CallbackInfo &info);
+  Napi::Value SetVolume(const Napi::CallbackInfo &info);
+  Napi::Value GetVolume(const Napi::CallbackInfo &info);
+  Napi::Value SetMuted(const Napi::CallbackInfo &info);
+  Napi::Value IsMuted(const Napi::CallbackInfo &info);
+  Napi::Value SetBalance(const Napi::CallbackInfo &info);
+  Napi::Value GetBalance(const Napi::CallbackInfo &info);
+  Napi::Value SetSyncOffset(const Napi::CallbackInfo &info);
+  Napi::Value GetSyncOffset(const Napi::CallbackInfo &info);
+  Napi::Value SetAudioMixers(const Napi::CallbackInfo &info);
+  Napi::Value GetAudioMixers(const Napi::CallbackInfo &info);
+  Napi::Value SetEnabled(const Napi::CallbackInfo &info);
+  Napi::Value IsEnabled(const Napi::CallbackInfo &info);
+  Napi::Value AddFilter(const Napi::CallbackInfo &info);
+  Napi::Value RemoveFilter(const Napi::CallbackInfo &info);
+  Napi::Value GetFilter(const Napi::CallbackInfo &info);
+  Napi::Value GetFilters(const Napi::CallbackInfo &info);
+  Napi::Value SetFilterOrder(const Napi::CallbackInfo &info);
 
+  obs_source_t *Detach();
+
+  static Napi::Object FromReference(Napi::Env env, obs_source_t *source);
   static Napi::Function GetClass(Napi::Env env);
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
-  obs_source_t *sourceReference;
+  // The class exported by Init, the constructor of every wrapper created
+  // from native code.
+  static Napi::FunctionReference constructor;
+
+  obs_source_t *sourceReference = nullptr;
 
 private:
-  Napi::ThreadSafeFunction signalHandler;
-  signal_handler_t* sourceSignalHandler;
+  bool NamesCurrentMedia(Napi::Object object);
+  void SetupMediaCache();
+  static const char *GetMediaStateName(int state);
+  static void MediaTick(void *param, float seconds);
+
+  SignalDispatcher signals;
+  bool mediaCached = false;
+  // Refreshed once per frame on the graphics thread, read by Node.js.
+  std::atomic<int64_t> mediaTime{0};
+  std::atomic<int64_t> mediaDuration{0};
+  std::atomic<int> mediaState{OBS_MEDIA_STATE_NONE};
   std::string sourceType;
   std::string name;
 };
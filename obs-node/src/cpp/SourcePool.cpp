@@ -0,0 +1,378 @@
+#include "SourcePool.h"
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <util/platform.h>
+#include "SettingsMarshaller.h"
+#include "Source.h"
+
+// Private setting holding the settings a pooled source is reset to.
+static const char *poolSettingsKey = "pool_settings";
+// Pooled sources are mixed into the first track, like every other source.
+static const uint32_t defaultMixers = 1;
+
+struct ParkedSource {
+  std::string key;
+  obs_source_t *source;
+  uint64_t parkedAt;
+};
+
+// Oldest first.
+static std::vector<ParkedSource> parked;
+static size_t minIdle = 0;
+static size_t maxIdle = 8;
+static uint64_t idleTimeoutNs = 300000000000ULL;
+
+static uint64_t hits = 0;
+static uint64_t misses = 0;
+static uint64_t evictions = 0;
+
+/**
+ * Collect the filters of a source with a reference each.
+ */
+static void CollectFilter([[maybe_unused]] obs_source_t *parent, obs_source_t *filter, void *param) {
+  obs_source_addref(filter);
+  static_cast<std::vector<obs_source_t *> *>(param)->push_back(filter);
+}
+
+static std::string MakeKey(const char *type, const char *json) {
+  return std::string(type) + "\n" + json;
+}
+
+/**
+ * Create a source that remembers its settings, so it can be reset to them
+ * when it is released.
+ */
+static obs_source_t *CreateSource(const std::string &type, const std::string &name, obs_data_t *settings) {
+  obs_source_t *source = obs_source_create(type.c_str(), name.c_str(), settings, nullptr);
+  if (source == nullptr) return nullptr;
+
+  obs_source_set_audio_mixers(source, defaultMixers);
+
+  obs_data_t *poolData = obs_source_get_private_settings(source);
+  obs_data_set_string(poolData, poolSettingsKey, obs_data_get_json(settings));
+  obs_data_release(poolData);
+  return source;
+}
+
+/**
+ * Take the most recently parked source with the key passed in out of the
+ * pool, the reference moves to the caller.
+ */
+static obs_source_t *TakeParked(const std::string &key) {
+  for (auto it = parked.rbegin(); it != parked.rend(); it++) {
+    if (it->key == key) {
+      obs_source_t *source = it->source;
+      parked.erase(std::next(it).base());
+      return source;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Stop the media of a source, restore its audio, remove its filters and put
+ * back the settings it was created with. Pooled sources are created without
+ * filters, so every filter was added by the previous user, the opacity
+ * filter of Animator included.
+ */
+static void Reset(obs_source_t *source, const char *json) {
+  if (obs_source_get_output_flags(source) & OBS_SOURCE_CONTROLLABLE_MEDIA) {
+    obs_source_media_stop(source);
+  }
+  obs_source_set_muted(source, false);
+  obs_source_set_volume(source, 1.0f);
+  obs_source_set_balance_value(source, 0.5f);
+  obs_source_set_sync_offset(source, 0);
+  obs_source_set_audio_mixers(source, defaultMixers);
+
+  // Filters cannot be removed while they are enumerated.
+  std::vector<obs_source_t *> filters;
+  obs_source_enum_filters(source, &CollectFilter, &filters);
+  for (obs_source_t *filter : filters) {
+    obs_source_filter_remove(source, filter);
+    obs_source_release(filter);
+  }
+
+  obs_data_t *settings = obs_source_get_settings(source);
+  // Updating reloads some sources, browser_source among them.
+  if (strcmp(obs_data_get_json(settings), json) != 0) {
+    obs_data_t *original = obs_data_create_from_json(json);
+    obs_data_clear(settings);
+    obs_data_apply(settings, original);
+    obs_data_release(original);
+    obs_source_update(source, nullptr);
+  }
+  obs_data_release(settings);
+}
+
+/**
+ * Destroy the oldest parked sources beyond the maximum pool size.
+ */
+static void Trim() {
+  while (parked.size() > maxIdle) {
+    obs_source_release(parked.front().source);
+    parked.erase(parked.begin());
+    evictions++;
+  }
+}
+
+/**
+ * Build the settings of a type from its defaults and the object passed in.
+ * Returns nullptr if the type has no defaults.
+ */
+static obs_data_t *GetSettings(const std::string &type, Napi::Value value) {
+  obs_data_t *settings = obs_get_source_defaults(type.c_str());
+  if (settings != nullptr && value.IsObject()) {
+    SettingsMarshaller::Apply(value.ToObject(), settings, SettingsKind::Source, type);
+  }
+  return settings;
+}
+
+/**
+ * Set the pool limits. minIdle sources per type and settings survive idle
+ * eviction, at most maxIdle sources are parked in total, and sources parked
+ * for longer than idleTimeout milliseconds are evicted.
+ */
+Napi::Value SourcePool::Configure(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be an object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object options = info[0].ToObject();
+  Napi::Value minValue = options.Get("minIdle");
+  Napi::Value maxValue = options.Get("maxIdle");
+  Napi::Value timeoutValue = options.Get("idleTimeout");
+
+  for (const Napi::Value &value : {minValue, maxValue, timeoutValue}) {
+    if (!value.IsUndefined() && (!value.IsNumber() || value.As<Napi::Number>().Int64Value() < 0)) {
+      Napi::TypeError::New(env, "minIdle, maxIdle and idleTimeout must be non-negative numbers")
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  if (!minValue.IsUndefined()) minIdle = minValue.As<Napi::Number>().Int64Value();
+  if (!maxValue.IsUndefined()) maxIdle = maxValue.As<Napi::Number>().Int64Value();
+  if (!timeoutValue.IsUndefined()) idleTimeoutNs = timeoutValue.As<Napi::Number>().Int64Value() * 1000000ULL;
+
+  Trim();
+  return env.Null();
+}
+
+/**
+ * Get a source of the type and settings passed in, from the pool if one is
+ * parked and created otherwise.
+ */
+Napi::Value SourcePool::Acquire(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "First two arguments must be strings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!info[2].IsUndefined() && !info[2].IsNull() && !info[2].IsObject()) {
+    Napi::TypeError::New(env, "Third argument must be an object or null")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string type = info[0].ToString().Utf8Value();
+  std::string name = info[1].ToString().Utf8Value();
+  obs_data_t *settings = GetSettings(type, info[2]);
+
+  if (settings == nullptr) {
+    Napi::TypeError::New(env, "Could not get source default settings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *source = TakeParked(MakeKey(type.c_str(), obs_data_get_json(settings)));
+  if (source != nullptr) {
+    hits++;
+    obs_source_set_name(source, name.c_str());
+  } else {
+    misses++;
+    source = CreateSource(type, name, settings);
+  }
+  obs_data_release(settings);
+
+  if (source == nullptr) {
+    Napi::TypeError::New(env, "Could not create source object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object object = Source::FromReference(env, source);
+  // The Source object holds its own reference.
+  obs_source_release(source);
+  return object;
+}
+
+/**
+ * Reset a source and park it in the pool. The Source object passed in can
+ * not be used afterwards. Sources should be removed from their scenes first.
+ */
+Napi::Value SourcePool::Release(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be a source object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *source = nullptr;
+  try {
+    source = Source::Unwrap(info[0].ToObject().Get("source").ToObject())->Detach();
+  } catch (const std::exception &e) {
+    Napi::TypeError::New(env, "First argument must be a source object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (source == nullptr) return env.Null();
+
+  // Sources not created by the pool are parked with their current settings.
+  obs_data_t *poolData = obs_source_get_private_settings(source);
+  std::string json = obs_data_get_string(poolData, poolSettingsKey);
+  obs_data_release(poolData);
+
+  if (json.empty()) {
+    obs_data_t *settings = obs_source_get_settings(source);
+    json = obs_data_get_json(settings);
+    obs_data_release(settings);
+  } else {
+    Reset(source, json.c_str());
+  }
+
+  parked.push_back({MakeKey(obs_source_get_id(source), json.c_str()), source, os_gettime_ns()});
+  Trim();
+  return env.Null();
+}
+
+/**
+ * Create sources of the type and settings passed in until as many as the
+ * count passed in are parked, so the first acquire is warm as well.
+ */
+Napi::Value SourcePool::Prewarm(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!info[1].IsUndefined() && !info[1].IsNull() && !info[1].IsObject()) {
+    Napi::TypeError::New(env, "Second argument must be an object or null")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  size_t count = info[2].IsNumber() ? info[2].As<Napi::Number>().Uint32Value() : 1;
+  std::string type = info[0].ToString().Utf8Value();
+  obs_data_t *settings = GetSettings(type, info[1]);
+
+  if (settings == nullptr) {
+    Napi::TypeError::New(env, "Could not get source default settings")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string key = MakeKey(type.c_str(), obs_data_get_json(settings));
+  size_t existing = 0;
+  for (const ParkedSource &entry : parked) {
+    if (entry.key == key) existing++;
+  }
+
+  for (; existing < count && parked.size() < maxIdle; existing++) {
+    obs_source_t *source = CreateSource(type, "pooled " + type, settings);
+    if (source == nullptr) break;
+    parked.push_back({key, source, os_gettime_ns()});
+  }
+  obs_data_release(settings);
+
+  return env.Null();
+}
+
+/**
+ * Destroy the sources parked for longer than the idle timeout, keeping
+ * minIdle of each type and settings.
+ */
+Napi::Value SourcePool::Evict(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::unordered_map<std::string, size_t> counts;
+  for (const ParkedSource &entry : parked) {
+    counts[entry.key]++;
+  }
+
+  uint64_t now = os_gettime_ns();
+  for (auto it = parked.begin(); it != parked.end();) {
+    size_t &count = counts[it->key];
+    if (now - it->parkedAt > idleTimeoutNs && count > minIdle) {
+      obs_source_release(it->source);
+      it = parked.erase(it);
+      count--;
+      evictions++;
+    } else {
+      it++;
+    }
+  }
+
+  return env.Null();
+}
+
+/**
+ * Destroy every parked source.
+ */
+Napi::Value SourcePool::Clear(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  for (const ParkedSource &entry : parked) {
+    obs_source_release(entry.source);
+  }
+  evictions += parked.size();
+  parked.clear();
+
+  return env.Null();
+}
+
+/**
+ * Get the number of parked sources, acquires served from and missing the
+ * pool and evicted sources.
+ */
+Napi::Value SourcePool::GetStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("parkedSources", Napi::Number::New(env, parked.size()));
+  stats.Set("hits", Napi::Number::New(env, hits));
+  stats.Set("misses", Napi::Number::New(env, misses));
+  stats.Set("evictions", Napi::Number::New(env, evictions));
+
+  return stats;
+}
+
+Napi::Object SourcePool::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Object sourcePoolObject = Napi::Object::New(env);
+  sourcePoolObject.Set(Napi::String::New(env, "configure"), Napi::Function::New(env, Configure));
+  sourcePoolObject.Set(Napi::String::New(env, "acquire"), Napi::Function::New(env, Acquire));
+  sourcePoolObject.Set(Napi::String::New(env, "release"), Napi::Function::New(env, Release));
+  sourcePoolObject.Set(Napi::String::New(env, "prewarm"), Napi::Function::New(env, Prewarm));
+  sourcePoolObject.Set(Napi::String::New(env, "evict"), Napi::Function::New(env, Evict));
+  sourcePoolObject.Set(Napi::String::New(env, "clear"), Napi::Function::New(env, Clear));
+  sourcePoolObject.Set(Napi::String::New(env, "getStats"), Napi::Function::New(env, GetStats));
+
+  exports.Set(Napi::String::New(env, "SourcePool"), sourcePoolObject);
+  return exports;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <napi.h>
+#include <obs.h>
+
+/**
+ * Keeps released sources alive to be handed out again, so sources that are
+ * slow to start, such as browser_source with its CEF process and page load,
+ * are only created once. Sources are parked by type and settings, reset to
+ * the settings they were acquired with, and destroyed once they have been
+ * idle for too long or the pool is full.
+ */
+namespace SourcePool {
+  Napi::Value Configure(const Napi::CallbackInfo &info);
+  Napi::Value Acquire(const Napi::CallbackInfo &info);
+  Napi::Value Release(const Napi::CallbackInfo &info);
+  Napi::Value Prewarm(const Napi::CallbackInfo &info);
+  Napi::Value Evict(const Napi::CallbackInfo &info);
+  Napi::Value Clear(const Napi::CallbackInfo &info);
+  Napi::Value GetStats(const Napi::CallbackInfo &info);
+
+  Napi::Object Init(Napi::Env env, Napi::Object exports);
+};
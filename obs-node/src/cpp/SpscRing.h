@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+/**
+ * Lock-free ring buffer for exactly one producer thread and one consumer
+ * thread. The capacity is rounded up to a power of two. Items left in the
+ * ring when it is destroyed are not cleaned up, the owner has to drain it.
+ */
+template <typename T>
+class SpscRing {
+public:
+  explicit SpscRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    slots.resize(size);
+    mask = size - 1;
+  }
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  /**
+   * Add an item, only called from the producer. Returns false if the ring is full.
+   */
+  bool Push(const T &item) {
+    size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail - head.load(std::memory_order_acquire) > mask) {
+      return false;
+    }
+
+    slots[currentTail & mask] = item;
+    tail.store(currentTail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Remove the oldest item, only called from the consumer. Returns false if
+   * the ring is empty.
+   */
+  bool Pop(T &item) {
+    size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    item = slots[currentHead & mask];
+    head.store(currentHead + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Empty() const {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  size_t Size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+private:
+  std::vector<T> slots;
+  size_t mask;
+  // Keep the indices on separate cache lines so the two threads do not
+  // invalidate each other's line on every operation.
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
@@ -1,4 +1,83 @@
 #include "StreamOutput.h"
+#include "StreamOutputInternal.h"
+#include <algorithm>
+
+/**
+ * Parse the batch options shared by the output and its subscribers. Without
+ * batch options every packet is delivered on its own. Throws a TypeError
+ * and returns false if the options are invalid.
+ */
+static bool ParseBatchOptions(Napi::Env env, Napi::Value batch, int64_t &maxPackets, int64_t &maxLatencyUs) {
+  maxPackets = 1;
+  maxLatencyUs = 0;
+  if (batch.IsUndefined()) return true;
+
+  if (!batch.IsObject()) {
+    Napi::TypeError::New(env, "batch must be an object")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value packets = batch.ToObject().Get("maxPackets");
+  Napi::Value latencyUs = batch.ToObject().Get("maxLatencyUs");
+  if ((!packets.IsUndefined() && !packets.IsNumber()) ||
+      (!latencyUs.IsUndefined() && !latencyUs.IsNumber())) {
+    Napi::TypeError::New(env, "batch.maxPackets and batch.maxLatencyUs must be numbers")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  maxPackets = packets.IsNumber() ? packets.ToNumber().Int64Value() : 0;
+  maxLatencyUs = latencyUs.IsNumber() ? latencyUs.ToNumber().Int64Value() : 0;
+  if (maxPackets < 0 || maxLatencyUs < 0 || (maxPackets == 0 && maxLatencyUs == 0)) {
+    Napi::TypeError::New(env, "batch requires a positive maxPackets or maxLatencyUs")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Parse the backpressure options shared by the output and its subscribers.
+ * Without backpressure options the queue is unbounded. Throws a TypeError
+ * and returns false if the options are invalid.
+ */
+static bool ParseBackpressureOptions(Napi::Env env, Napi::Value backpressure, int64_t &capacity, BackpressurePolicy &policy) {
+  capacity = 0;
+  policy = BackpressurePolicy::Block;
+  if (backpressure.IsUndefined()) return true;
+
+  if (!backpressure.IsObject()) {
+    Napi::TypeError::New(env, "backpressure must be an object")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value capacityValue = backpressure.ToObject().Get("capacity");
+  Napi::Value policyValue = backpressure.ToObject().Get("policy");
+  if (!capacityValue.IsNumber() || capacityValue.ToNumber().Int64Value() < 0) {
+    Napi::TypeError::New(env, "backpressure.capacity must be a non-negative number")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  capacity = capacityValue.ToNumber().Int64Value();
+
+  std::string policyName = policyValue.IsString() ? policyValue.ToString().Utf8Value() : "block";
+  if (policyName == "block") {
+    policy = BackpressurePolicy::Block;
+  } else if (policyName == "dropOldest") {
+    policy = BackpressurePolicy::DropOldestNonKeyframe;
+  } else if (policyName == "dropUntilKeyframe") {
+    policy = BackpressurePolicy::DropUntilKeyframe;
+  } else {
+    Napi::TypeError::New(env, "backpressure.policy must be block, dropOldest or dropUntilKeyframe")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  return true;
+}
 
 /**
  * Create a StreamOutput object. This object wraps the output of a video
@@ -21,12 +100,12 @@ StreamOutput::StreamOutput(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  // Create an OBS settings object for this output. The ID stream_output represents
-  // the output defined by the StreamOutputInternal class.
-  auto outputId = new std::string("stream_output");
-  obs_data_t *settings = obs_output_defaults(outputId->c_str());
+  // The session collects the callbacks and options for the output defined by
+  // the StreamOutputInternal class. It owns the thread safe functions, so
+  // returning early after an invalid option releases them again.
+  auto session = std::make_shared<StreamOutputSession>();
 
-  // Get the onData function passed in and add it to the OBS settings object
+  // Get the onData function passed in
   Napi::Object callbacks = info[1].ToObject();
   Napi::Value onData = callbacks.Get("onData");
   if (!onData.IsFunction()) {
@@ -35,16 +114,9 @@ StreamOutput::StreamOutput(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  onDataRef = Napi::ThreadSafeFunction::New(
-      env,
-      onData.As<Napi::Function>(),
-      "StreamOutput.onData",
-      0,
-      1
-  );
-  obs_data_set_int(settings, "onData", reinterpret_cast<long long int>(&onDataRef));
+  session->onData = PacketSink::CreateCallback(env, onData.As<Napi::Function>(), "StreamOutput.onData");
 
-  // Get the onStop function passed in and add it to the OBS settings object
+  // Get the onStop function passed in
   Napi::Value onStop = callbacks.Get("onStop");
   if (!onStop.IsFunction()) {
     Napi::TypeError::New(env, "onStop must be a function")
@@ -52,26 +124,228 @@ StreamOutput::StreamOutput(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  onStopRef = Napi::ThreadSafeFunction::New(
+  session->onStop = Napi::ThreadSafeFunction::New(
       env,
       onStop.As<Napi::Function>(),
-      "StreamOutput.onData",
+      "StreamOutput.onStop",
       0,
       1
   );
-  obs_data_set_int(settings, "onStop", reinterpret_cast<long long int>(&onStopRef));
 
-  // Pass in this object and an AsyncContext to allow us to call back into Node.js from the internal output
-  auto jsThis = new Napi::ObjectReference(Napi::Persistent(env.Global()));
-  obs_data_set_int(settings, "jsThis", reinterpret_cast<long long int>(jsThis));
-
-  auto asyncContext = new Napi::AsyncContext(env, "streamOutput", jsThis->Value());
-  obs_data_set_int(settings, "asyncContext", reinterpret_cast<long long int>(asyncContext));
+  // In zero copy mode the packet payload is handed to Node.js as an external
+  // Buffer that keeps the OBS packet alive instead of being copied.
+  Napi::Value zeroCopy = callbacks.Get("zeroCopy");
+  if (!zeroCopy.IsUndefined() && !zeroCopy.IsBoolean()) {
+    Napi::TypeError::New(env, "zeroCopy must be a boolean")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  session->zeroCopy = zeroCopy.IsBoolean() && zeroCopy.ToBoolean();
+
+  // In batch mode packets are collected natively and passed to onData as an
+  // array once maxPackets have been queued or maxLatencyUs has elapsed.
+  int64_t batchMaxPackets, batchMaxLatencyUs;
+  if (!ParseBatchOptions(env, callbacks.Get("batch"), batchMaxPackets, batchMaxLatencyUs)) return;
+  session->batchMaxPackets = batchMaxPackets;
+  session->batchMaxLatencyUs = batchMaxLatencyUs;
+
+  // Bound the native packet queue. When it is full the policy decides whether
+  // the output thread waits for Node.js or packets are dropped.
+  int64_t queueCapacity;
+  BackpressurePolicy queuePolicy;
+  if (!ParseBackpressureOptions(env, callbacks.Get("backpressure"), queueCapacity, queuePolicy)) return;
+  session->queueCapacity = queueCapacity;
+  session->queuePolicy = queuePolicy;
+
+  // In pull mode packets wait in a lock-free ring per track until Node.js
+  // reads them, onReadable is called when a track that was read empty has
+  // data again.
+  Napi::Value pull = callbacks.Get("pull");
+  int64_t pullCapacity = 0;
+  if (pull.IsObject()) {
+    Napi::Value capacity = pull.ToObject().Get("capacity");
+    if (!capacity.IsUndefined() && (!capacity.IsNumber() || capacity.ToNumber().Int64Value() <= 0)) {
+      Napi::TypeError::New(env, "pull.capacity must be a positive number")
+          .ThrowAsJavaScriptException();
+      return;
+    }
+    pullCapacity = capacity.IsNumber() ? capacity.ToNumber().Int64Value() : 256;
+
+    Napi::Value onReadable = callbacks.Get("onReadable");
+    if (!onReadable.IsFunction()) {
+      Napi::TypeError::New(env, "onReadable must be a function in pull mode")
+          .ThrowAsJavaScriptException();
+      return;
+    }
+
+    session->onReadable = Napi::ThreadSafeFunction::New(
+        env,
+        onReadable.As<Napi::Function>(),
+        "StreamOutput.onReadable",
+        0,
+        1
+    );
+  } else if (!pull.IsUndefined()) {
+    Napi::TypeError::New(env, "pull must be an object")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  session->pullCapacity = pullCapacity;
+
+  // With rtp set, H.264 video is split into RTP payloads of at most mtu bytes
+  // on the output thread unless video is false. With rtp.audio set, Opus
+  // packets are framed as complete RTP packets.
+  Napi::Value rtp = callbacks.Get("rtp");
+  int64_t rtpMtu = 0;
+  bool rtpAudio = false;
+  int64_t rtpAudioSsrc = 0;
+  int64_t rtpAudioPayloadType = 120;
+  if (rtp.IsObject()) {
+    Napi::Object rtpOptions = rtp.ToObject();
+    Napi::Value mtu = rtpOptions.Get("mtu");
+    if (!mtu.IsUndefined() && (!mtu.IsNumber() || mtu.ToNumber().Int64Value() < 16 || mtu.ToNumber().Int64Value() > 65535)) {
+      Napi::TypeError::New(env, "rtp.mtu must be a number between 16 and 65535")
+          .ThrowAsJavaScriptException();
+      return;
+    }
+    Napi::Value video = rtpOptions.Get("video");
+    if (!video.IsBoolean() || video.ToBoolean()) {
+      rtpMtu = mtu.IsNumber() ? mtu.ToNumber().Int64Value() : 1200;
+    }
+
+    Napi::Value audio = rtpOptions.Get("audio");
+    if (audio.IsObject()) {
+      Napi::Value ssrc = audio.ToObject().Get("ssrc");
+      Napi::Value payloadType = audio.ToObject().Get("payloadType");
+      if (!ssrc.IsNumber() || (!payloadType.IsUndefined() && !payloadType.IsNumber())) {
+        Napi::TypeError::New(env, "rtp.audio.ssrc and rtp.audio.payloadType must be numbers")
+            .ThrowAsJavaScriptException();
+        return;
+      }
+      rtpAudio = true;
+      rtpAudioSsrc = ssrc.ToNumber().Int64Value();
+      if (payloadType.IsNumber()) {
+        rtpAudioPayloadType = payloadType.ToNumber().Int64Value();
+      }
+    } else if (!audio.IsUndefined()) {
+      Napi::TypeError::New(env, "rtp.audio must be an object")
+          .ThrowAsJavaScriptException();
+      return;
+    }
+  } else if (!rtp.IsUndefined()) {
+    Napi::TypeError::New(env, "rtp must be an object")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  session->rtpMtu = rtpMtu;
+  session->rtpAudio = rtpAudio;
+  session->rtpAudioSsrc = rtpAudioSsrc;
+  session->rtpAudioPayloadType = rtpAudioPayloadType;
 
   name = info[0].ToString().Utf8Value();
-  outputReference = obs_output_create(outputId->c_str(), name.c_str(), settings, nullptr);
+  outputReference = StreamOutputInternal::CreateOutput(name, session);
+  if (outputReference == nullptr) {
+    Napi::Error::New(env, "Could not create output")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  signals.Connect(obs_output_get_signal_handler(outputReference));
+
+  this->session = session;
+}
 
-  delete outputId;
+/**
+ * Release the output when the object is garbage collected without having
+ * been released explicitly.
+ */
+StreamOutput::~StreamOutput() {
+  Dispose();
+}
+
+/**
+ * Release the OBS output, stopping it if it is active, and every callback
+ * of the output and its subscribers. Safe to call more than once.
+ */
+void StreamOutput::Dispose() {
+  // Once OBS has shut down it has already freed its outputs.
+  if (outputReference != nullptr && obs_initialized()) {
+    signals.Disconnect();
+
+    for (auto &entry : subscribers) {
+      calldata_t cd = {0};
+      calldata_set_ptr(&cd, "sink", &entry.second.sink);
+      proc_handler_call(obs_output_get_proc_handler(outputReference), "remove_subscriber", &cd);
+      calldata_free(&cd);
+    }
+
+    obs_output_release(outputReference);
+  }
+  outputReference = nullptr;
+
+  for (auto &entry : subscribers) {
+    entry.second.sink->Close();
+    entry.second.onData.Release();
+  }
+  subscribers.clear();
+
+  // The output held the other reference, this releases the callbacks.
+  session.reset();
+}
+
+/**
+ * Throw an error and return true if the output has already been released.
+ */
+bool StreamOutput::IsReleased(Napi::Env env) {
+  if (outputReference != nullptr) {
+    return false;
+  }
+
+  Napi::Error::New(env, "StreamOutput has been released")
+      .ThrowAsJavaScriptException();
+  return true;
+}
+
+/**
+ * Release the output and its callbacks. The object cannot be used afterwards.
+ */
+Napi::Value StreamOutput::Release(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Dispose();
+
+  return env.Null();
+}
+
+/**
+ * Start forwarding the output signals named in the array passed in to the
+ * event bus.
+ */
+Napi::Value StreamOutput::Subscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  signals.UpdateSubscriptions(env, info[0], true);
+  return env.Null();
+}
+
+/**
+ * Stop forwarding the output signals named in the array passed in.
+ */
+Napi::Value StreamOutput::Unsubscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  signals.UpdateSubscriptions(env, info[0], false);
+  return env.Null();
+}
+
+/**
+ * Get the handle the events of this output are tagged with on the event bus.
+ */
+Napi::Value StreamOutput::GetHandle(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  return Napi::Number::New(env, signals.GetHandle());
 }
 
 /**
@@ -79,6 +353,7 @@ StreamOutput::StreamOutput(const Napi::CallbackInfo &info) : ObjectWrap(info) {
  */
 Napi::Value StreamOutput::SetVideoEncoder(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
 
   if (info.Length() != 1) {
     Napi::TypeError::New(env, "Wrong number of arguments")
@@ -111,6 +386,7 @@ Napi::Value StreamOutput::SetVideoEncoder(const Napi::CallbackInfo &info) {
  */
 Napi::Value StreamOutput::SetAudioEncoder(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
 
   if (info.Length() < 1) {
     Napi::TypeError::New(env, "Wrong number of arguments")
@@ -148,6 +424,7 @@ Napi::Value StreamOutput::SetAudioEncoder(const Napi::CallbackInfo &info) {
  */
 Napi::Value StreamOutput::SetMixer(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
 
   if (!info[0].IsNumber()) {
     Napi::TypeError::New(env, "First argument must be a number")
@@ -161,31 +438,45 @@ Napi::Value StreamOutput::SetMixer(const Napi::CallbackInfo &info) {
 }
 
 /**
- * Update the callbacks registered for this output
+ * Replace the onData and onStop callbacks of this output. This is only
+ * possible while the output is stopped, the new callbacks are used from the
+ * next start on.
  */
 Napi::Value StreamOutput::UpdateSettings(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
 
-  // Get the current settings object
-  if (!info[0].IsObject()) {}
-  Napi::Object callbacks = info[0].ToObject();
-  obs_data_t *settings = obs_output_get_settings(outputReference);
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be an object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
 
-  // Get the callback pointers and update the settings object
+  if (obs_output_active(outputReference)) {
+    Napi::Error::New(env, "Callbacks can only be updated while the output is stopped")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object callbacks = info[0].ToObject();
   Napi::Value onData = callbacks.Get("onData");
   if (onData.IsFunction()) {
-    Napi::FunctionReference onDataRef = Napi::Persistent(onData.As<Napi::Function>());
-    obs_data_set_int(settings, "onData", reinterpret_cast<long long int>(&onDataRef));
+    StreamOutputSession::Release(session->onData);
+    session->onData = PacketSink::CreateCallback(env, onData.As<Napi::Function>(), "StreamOutput.onData");
   }
 
   Napi::Value onStop = callbacks.Get("onStop");
   if (onStop.IsFunction()) {
-    Napi::FunctionReference onStopRef = Napi::Persistent(onStop.As<Napi::Function>());
-    obs_data_set_int(settings, "onStop", reinterpret_cast<long long int>(&onStopRef));
+    StreamOutputSession::Release(session->onStop);
+    session->onStop = Napi::ThreadSafeFunction::New(
+        env,
+        onStop.As<Napi::Function>(),
+        "StreamOutput.onStop",
+        0,
+        1
+    );
   }
 
-  // Update the settings object
-  obs_output_update(outputReference, settings);
   return env.Null();
 }
 
@@ -194,6 +485,7 @@ Napi::Value StreamOutput::UpdateSettings(const Napi::CallbackInfo &info) {
  */
 Napi::Value StreamOutput::Start(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
 
   if (!obs_output_start(outputReference)) {
     Napi::TypeError::New(env, "Could not start output")
@@ -209,12 +501,223 @@ Napi::Value StreamOutput::Start(const Napi::CallbackInfo &info) {
  */
 Napi::Value StreamOutput::Stop(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
 
   obs_output_stop(outputReference);
 
   return env.Null();
 }
 
+/**
+ * Read up to maxPackets packets of a track in pull mode. Returns an empty
+ * array if nothing is buffered, onReadable is then called once more data
+ * arrives. If a Float64Array is passed as third argument, the metadata of
+ * the packets is written into it and at most as many packets are read as it
+ * has room for.
+ */
+Napi::Value StreamOutput::Read(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  if (!info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Track and maximum packet count must be numbers")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  int64_t maxPackets = info[1].ToNumber().Int64Value();
+  Napi::Float64Array meta;
+  if (info[2].IsTypedArray() && info[2].As<Napi::TypedArray>().TypedArrayType() == napi_float64_array) {
+    meta = info[2].As<Napi::Float64Array>();
+    maxPackets = std::min<int64_t>(maxPackets, meta.ElementLength() / PacketMeta::Fields);
+  } else if (!info[2].IsUndefined()) {
+    Napi::TypeError::New(env, "Third argument must be a Float64Array")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<encoder_packet> packets;
+  calldata_t cd = {0};
+  calldata_set_int(&cd, "track", info[0].ToNumber().Int64Value());
+  calldata_set_int(&cd, "max_packets", maxPackets);
+  calldata_set_ptr(&cd, "packets", &packets);
+  proc_handler_call(obs_output_get_proc_handler(outputReference), "read", &cd);
+  calldata_free(&cd);
+
+  auto array = Napi::Array::New(env, packets.size());
+  for (uint32_t i = 0; i < packets.size(); i++) {
+    if (!meta.IsEmpty()) {
+      PacketMeta::Write(meta.Data() + i * PacketMeta::Fields, packets[i]);
+    }
+    array.Set(i, PacketSink::PacketToValue(env, packets[i], session->zeroCopy));
+  }
+
+  return array;
+}
+
+/**
+ * Get the statistics of the native packet queue.
+ */
+Napi::Value StreamOutput::GetStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  calldata_t cd = {0};
+  proc_handler_t *handler = obs_output_get_proc_handler(outputReference);
+  if (!proc_handler_call(handler, "get_stats", &cd)) {
+    calldata_free(&cd);
+    Napi::Error::New(env, "Could not get output statistics")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("droppedPackets", Napi::Number::New(env, calldata_int(&cd, "dropped_packets")));
+  stats.Set("droppedBytes", Napi::Number::New(env, calldata_int(&cd, "dropped_bytes")));
+  stats.Set("queuedPackets", Napi::Number::New(env, calldata_int(&cd, "queued_packets")));
+  calldata_free(&cd);
+
+  return stats;
+}
+
+/**
+ * Add another consumer of the encoded packets. Subscribers share the
+ * output's encoders but have their own onData callback, batching and
+ * backpressure, so a slow subscriber only drops its own packets. A
+ * subscriber added to a running output starts with the cached video since
+ * the last keyframe, or at the next keyframe if instantJoin is false.
+ * Returns an ID to pass to removeSubscriber.
+ */
+Napi::Value StreamOutput::AddSubscriber(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be an object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object options = info[0].ToObject();
+  Napi::Value onData = options.Get("onData");
+  if (!onData.IsFunction()) {
+    Napi::TypeError::New(env, "onData must be a function")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Value zeroCopy = options.Get("zeroCopy");
+  if (!zeroCopy.IsUndefined() && !zeroCopy.IsBoolean()) {
+    Napi::TypeError::New(env, "zeroCopy must be a boolean")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Value instantJoin = options.Get("instantJoin");
+  if (!instantJoin.IsUndefined() && !instantJoin.IsBoolean()) {
+    Napi::TypeError::New(env, "instantJoin must be a boolean")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  int64_t batchMaxPackets, batchMaxLatencyUs;
+  if (!ParseBatchOptions(env, options.Get("batch"), batchMaxPackets, batchMaxLatencyUs)) return env.Null();
+
+  // A subscriber must never stall the output thread, which would hold up
+  // every other consumer.
+  int64_t queueCapacity;
+  BackpressurePolicy queuePolicy;
+  if (!ParseBackpressureOptions(env, options.Get("backpressure"), queueCapacity, queuePolicy)) return env.Null();
+  if (queueCapacity > 0 && queuePolicy == BackpressurePolicy::Block) {
+    Napi::TypeError::New(env, "Subscribers cannot use the block backpressure policy")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Subscriber subscriber;
+  subscriber.onData = PacketSink::CreateCallback(env, onData.As<Napi::Function>(), "StreamOutput.subscriber");
+  subscriber.sink = PacketSink::Create(
+      subscriber.onData,
+      zeroCopy.IsBoolean() && zeroCopy.ToBoolean(),
+      batchMaxPackets,
+      batchMaxLatencyUs,
+      queueCapacity,
+      queuePolicy,
+      obs_output_get_video_encoder(outputReference) != nullptr
+  );
+
+  calldata_t cd = {0};
+  calldata_set_ptr(&cd, "sink", &subscriber.sink);
+  calldata_set_bool(&cd, "replay", !instantJoin.IsBoolean() || instantJoin.ToBoolean());
+  proc_handler_call(obs_output_get_proc_handler(outputReference), "add_subscriber", &cd);
+  calldata_free(&cd);
+
+  uint32_t id = nextSubscriberId++;
+  subscribers[id] = subscriber;
+  return Napi::Number::New(env, id);
+}
+
+/**
+ * Remove a subscriber. Packets still queued for it are discarded.
+ */
+Napi::Value StreamOutput::RemoveSubscriber(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto it = subscribers.find(info[0].ToNumber().Uint32Value());
+  if (it == subscribers.end()) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  // Once the procedure returns the output thread no longer pushes to the
+  // sink, so it is safe to stop it and release its callback.
+  calldata_t cd = {0};
+  calldata_set_ptr(&cd, "sink", &it->second.sink);
+  proc_handler_call(obs_output_get_proc_handler(outputReference), "remove_subscriber", &cd);
+  calldata_free(&cd);
+
+  it->second.sink->Close();
+  it->second.onData.Release();
+  subscribers.erase(it);
+
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Get the statistics of a subscriber's packet queue.
+ */
+Napi::Value StreamOutput::GetSubscriberStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (IsReleased(env)) return env.Null();
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "First argument must be a number")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto it = subscribers.find(info[0].ToNumber().Uint32Value());
+  if (it == subscribers.end()) {
+    Napi::Error::New(env, "Unknown subscriber")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto &sink = it->second.sink;
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("droppedPackets", Napi::Number::New(env, sink->GetDroppedPackets()));
+  stats.Set("droppedBytes", Napi::Number::New(env, sink->GetDroppedBytes()));
+  stats.Set("queuedPackets", Napi::Number::New(env, sink->GetQueuedPackets()));
+
+  return stats;
+}
+
 /**
  * Define this class as a type exposed to Node.js .
  */
@@ -225,7 +728,16 @@ Napi::Function StreamOutput::GetClass(Napi::Env env) {
       StreamOutput::InstanceMethod("setMixer", &StreamOutput::SetMixer),
       StreamOutput::InstanceMethod("updateSettings", &StreamOutput::UpdateSettings),
       StreamOutput::InstanceMethod("start", &StreamOutput::Start),
-      StreamOutput::InstanceMethod("stop", &StreamOutput::Stop)
+      StreamOutput::InstanceMethod("stop", &StreamOutput::Stop),
+      StreamOutput::InstanceMethod("getStats", &StreamOutput::GetStats),
+      StreamOutput::InstanceMethod("read", &StreamOutput::Read),
+      StreamOutput::InstanceMethod("addSubscriber", &StreamOutput::AddSubscriber),
+      StreamOutput::InstanceMethod("removeSubscriber", &StreamOutput::RemoveSubscriber),
+      StreamOutput::InstanceMethod("getSubscriberStats", &StreamOutput::GetSubscriberStats),
+      StreamOutput::InstanceMethod("release", &StreamOutput::Release),
+      StreamOutput::InstanceMethod("subscribe", &StreamOutput::Subscribe),
+      StreamOutput::InstanceMethod("unsubscribe", &StreamOutput::Unsubscribe),
+      StreamOutput::InstanceMethod("getHandle", &StreamOutput::GetHandle)
   });
 }
 
@@ -1,9 +1,14 @@
 #pragma once
 #include "Output.h"
+#include <map>
+#include <memory>
 #include <napi.h>
 #include <obs.h>
 #include "utils.h"
 #include "AudioEncoder.h"
+#include "PacketSink.h"
+#include "SignalDispatcher.h"
+#include "StreamOutputSession.h"
 #include "VideoEncoder.h"
 
 using Context = Napi::Reference<Napi::Value>;
@@ -11,6 +16,7 @@ using Context = Napi::Reference<Napi::Value>;
 class StreamOutput : public Napi::ObjectWrap<StreamOutput> {
 public:
   explicit StreamOutput(const Napi::CallbackInfo &info);
+  ~StreamOutput();
 
   Napi::Value SetVideoEncoder(const Napi::CallbackInfo &info);
   Napi::Value SetAudioEncoder(const Napi::CallbackInfo &info);
@@ -20,14 +26,33 @@ public:
 
   Napi::Value Start(const Napi::CallbackInfo &info);
   Napi::Value Stop(const Napi::CallbackInfo &info);
+  Napi::Value GetStats(const Napi::CallbackInfo &info);
+  Napi::Value Read(const Napi::CallbackInfo &info);
+  Napi::Value AddSubscriber(const Napi::CallbackInfo &info);
+  Napi::Value RemoveSubscriber(const Napi::CallbackInfo &info);
+  Napi::Value GetSubscriberStats(const Napi::CallbackInfo &info);
+  Napi::Value Release(const Napi::CallbackInfo &info);
+  Napi::Value Subscribe(const Napi::CallbackInfo &info);
+  Napi::Value Unsubscribe(const Napi::CallbackInfo &info);
+  Napi::Value GetHandle(const Napi::CallbackInfo &info);
 
   static Napi::Function GetClass(Napi::Env env);
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
 private:
+  void Dispose();
+  bool IsReleased(Napi::Env env);
+
   std::string name;
-  obs_output_t *outputReference;
-  Napi::ThreadSafeFunction onDataRef;
-  Napi::ThreadSafeFunction onStopRef;
+  obs_output_t *outputReference = nullptr;
+  std::shared_ptr<StreamOutputSession> session;
+  SignalDispatcher signals;
+
+  struct Subscriber {
+    std::shared_ptr<PacketSink> sink;
+    Napi::ThreadSafeFunction onData;
+  };
+  std::map<uint32_t, Subscriber> subscribers;
+  uint32_t nextSubscriberId = 1;
 };
 
@@ -1,24 +1,60 @@
 #include "StreamOutputInternal.h"
+#include <algorithm>
+
+thread_local std::shared_ptr<StreamOutputSession> StreamOutputInternal::pendingSession;
 
 /**
  * Constructor for StreamOutputInternal. This class is responsible for interacting
  * with OBS to pretend to be a streaming service and pass video data into Node.js.
  */
-StreamOutputInternal::StreamOutputInternal(
-  obs_output_t *output,
-  Napi::ThreadSafeFunction* onData,
-  Napi::ThreadSafeFunction* onStop,
-  Napi::ObjectReference* jsThis,
-  Napi::AsyncContext* asyncContext
-) {
+StreamOutputInternal::StreamOutputInternal(obs_output_t *output, std::shared_ptr<StreamOutputSession> session) {
   // output is a pointer to the OBS API struct representing this output
   this->output = output;
-  // The other member variables are the Node.js callbacks and the information
-  // needed to call them.
-  this->onData = onData;
-  this->onStop = onStop;
-  this->jsThis = jsThis;
-  this->asyncContext = asyncContext;
+  // The session holds the Node.js callbacks and the options of the output.
+  this->session = std::move(session);
+
+  // In pull mode packets bypass the queue and wait in a ring per track.
+  size_t pullCapacity = this->session->pullCapacity;
+  if (pullCapacity > 0) {
+    pullRings[OBS_ENCODER_AUDIO] = std::make_unique<SpscRing<encoder_packet>>(pullCapacity);
+    pullRings[OBS_ENCODER_VIDEO] = std::make_unique<SpscRing<encoder_packet>>(pullCapacity);
+  }
+
+  // Optionally split H.264 video into RTP payloads and frame Opus audio as
+  // RTP before it is queued.
+  if (this->session->rtpMtu > 0 || this->session->rtpAudio) {
+    packetizer = std::make_unique<RtpPacketizer>(this->session->rtpMtu);
+    if (this->session->rtpAudio) {
+      packetizer->EnableAudio(this->session->rtpAudioSsrc, this->session->rtpAudioPayloadType);
+    }
+  }
+
+  // Let StreamOutput query the queue statistics and read packets through the output's procedure handler.
+  proc_handler_t *handler = obs_output_get_proc_handler(output);
+  proc_handler_add(
+      handler,
+      "void get_stats(out int dropped_packets, out int dropped_bytes, out int queued_packets)",
+      &GetStats, this);
+  proc_handler_add(
+      handler,
+      "void read(in int track, in int max_packets, in ptr packets)",
+      &ReadPackets, this);
+  proc_handler_add(
+      handler,
+      "void add_subscriber(in ptr sink, in bool replay)",
+      &AddSubscriber, this);
+  proc_handler_add(
+      handler,
+      "void remove_subscriber(in ptr sink)",
+      &RemoveSubscriber, this);
+}
+
+/**
+ * Release any packets that were never read in pull mode and the cached video.
+ */
+StreamOutputInternal::~StreamOutputInternal() {
+  ClearCache();
+  ClearPull();
 }
 
 void StreamOutputInternal::LoadOutput() {
@@ -29,24 +65,31 @@ const char* StreamOutputInternal::GetName([[maybe_unused]] void* typeData) {
   return outputName;
 }
 
+/**
+ * Create an OBS output backed by a new StreamOutputInternal that uses the
+ * given session. Returns nullptr if OBS could not create the output.
+ */
+obs_output_t *StreamOutputInternal::CreateOutput(const std::string &name, std::shared_ptr<StreamOutputSession> session) {
+  // obs_output_create calls Create synchronously on this thread, which takes
+  // the session from here.
+  pendingSession = std::move(session);
+  obs_output_t *output = obs_output_create(outputId, name.c_str(), nullptr, nullptr);
+  pendingSession.reset();
+
+  return output;
+}
+
 /**
  * Create a new StreamOutputInternal. This is a static function enrolled with OBS to
- * be called when StreamOutput requests the output be created.
+ * be called when StreamOutput requests the output be created. Outputs of this
+ * type can only be created through CreateOutput.
  */
-void* StreamOutputInternal::Create(obs_data_t *settings, obs_output_t *output) {
-  long long onData = obs_data_get_int(settings, "onData");
-  long long onStop = obs_data_get_int(settings, "onStop");
-  long long jsThis = obs_data_get_int(settings, "jsThis");
-  long long asyncContext = obs_data_get_int(settings, "asyncContext");
+void* StreamOutputInternal::Create([[maybe_unused]] obs_data_t *settings, obs_output_t *output) {
+  if (!pendingSession) {
+    return nullptr;
+  }
 
-  auto data = new StreamOutputInternal(
-    output,
-    reinterpret_cast<Napi::ThreadSafeFunction *>(onData),
-    reinterpret_cast<Napi::ThreadSafeFunction *>(onStop),
-    reinterpret_cast<Napi::ObjectReference *>(jsThis),
-    reinterpret_cast<Napi::AsyncContext *>(asyncContext)
-  );
-  return data;
+  return new StreamOutputInternal(output, std::move(pendingSession));
 }
 
 /**
@@ -69,6 +112,23 @@ bool StreamOutputInternal::Start(void* data) {
   if (!obs_output_initialize_encoders(output->output, 0)) {
     return false;
   }
+
+  // Every start gets a fresh queue for the current onData callback. The
+  // output thread is idle, dropping the previous sink lets Create free it.
+  auto &session = output->session;
+  output->sink.reset();
+  if (!output->pullRings[0] && static_cast<napi_threadsafe_function>(session->onData) != nullptr) {
+    output->sink = PacketSink::Create(
+        session->onData, session->zeroCopy, session->batchMaxPackets, session->batchMaxLatencyUs,
+        session->queueCapacity, session->queuePolicy, false);
+  }
+  {
+    std::lock_guard<std::mutex> lock(output->subscribersMutex);
+    for (auto &subscriber : output->subscribers) subscriber->Open();
+  }
+  // Packets of the previous run that were never read would be read first
+  // otherwise, starting the new stream with stale media.
+  output->ClearPull();
   return obs_output_begin_data_capture(output->output, 0);
 }
 
@@ -77,48 +137,288 @@ bool StreamOutputInternal::Start(void* data) {
  */
 void StreamOutputInternal::Stop(void* data, [[maybe_unused]] uint64_t ts) {
   auto output = (StreamOutputInternal*)(data);
+
+  // Closing the queue first releases an output thread blocked on a full queue.
+  if (output->sink) output->sink->Close();
   obs_output_end_data_capture(output->output);
 
-  if (output->onStop != nullptr) {
-    output->onStop->BlockingCall();
+  // Hand over any packets still waiting for their batch to fill up.
+  if (output->sink) output->sink->Flush();
+  {
+    std::lock_guard<std::mutex> lock(output->subscribersMutex);
+    for (auto &subscriber : output->subscribers) {
+      subscriber->Close();
+      subscriber->Flush();
+    }
+    // The next start begins a new stream, nothing cached can be replayed.
+    output->ClearCache();
+  }
+
+  if (static_cast<napi_threadsafe_function>(output->session->onStop) != nullptr) {
+    output->session->onStop.NonBlockingCall();
   }
 }
 
 /**
- * 
+ * Queue an encoded packet for Node.js. Packets are delivered individually by
+ * default, in batch mode they accumulate in the queue until the batch is
+ * full or the latency window has passed and are then delivered in one call.
  */
 void StreamOutputInternal::OnPacket(void* data, encoder_packet *packet) {
   auto output = (StreamOutputInternal*)(data);
 
-  if (output->onData != nullptr) {
-    // Packets are reference counted objects, so create a new reference for this packet.
-    auto packetRef = new encoder_packet();
-    obs_encoder_packet_ref(packetRef, packet);
-
-    // Call the onData function in Node.js. The lambda is responsible for actually performing the call
-    // with access to the environment of the function, which is required to create objects that are properly
-    // tracked by the runtime.
-    output->onData->BlockingCall(packetRef, [](Napi::Env env, Napi::Function jsCallback, encoder_packet *data) {
-      // Create a Node.js Buffer and copy data into it
-      auto array = Napi::ArrayBuffer::New(env, data->size);
-      memcpy(array.Data(), data->data, data->size);
-      
-      // Do the actual function call, passing the data and the type of the packet.
-      jsCallback.Call( {array, Napi::Number::New(env, data->type)} );
-
-      // Release the reference we hold on the packet
-      obs_encoder_packet_release(data);
-      delete data;
+  // Keyframes get the encoder's SPS/PPS in front of them if they don't carry
+  // them already, so every keyframe can start decoding on its own.
+  encoder_packet keyframe{};
+  if (packet->type == OBS_ENCODER_VIDEO && packet->keyframe && output->AddParameterSets(packet, &keyframe)) {
+    packet = &keyframe;
+  }
+
+  // Packetizing replaces the packet with its RTP payloads.
+  auto &packetizer = output->packetizer;
+  bool isVideo = packet->type == OBS_ENCODER_VIDEO;
+  if (packetizer && (isVideo ? packetizer->IsVideoEnabled() : packetizer->IsAudioEnabled())) {
+    encoder_packet rtpPacket{};
+    bool packetized = isVideo
+        ? packetizer->PacketizeVideo(packet, &rtpPacket)
+        : packetizer->PacketizeAudio(packet, &rtpPacket);
+
+    if (packetized) {
+      output->Dispatch(&rtpPacket);
+      obs_encoder_packet_release(&rtpPacket);
+    }
+  } else {
+    output->Dispatch(packet);
+  }
+
+  if (keyframe.data != nullptr) {
+    obs_encoder_packet_release(&keyframe);
+  }
+}
+
+/**
+ * Copy a keyframe into out with the video encoder's extra data, the H.264
+ * SPS and PPS, in front of it. Returns false if the encoder has no extra
+ * data or the keyframe already starts with it.
+ */
+bool StreamOutputInternal::AddParameterSets(encoder_packet *packet, encoder_packet *out) {
+  obs_encoder_t *encoder = obs_output_get_video_encoder(output);
+  uint8_t *extraData = nullptr;
+  size_t extraDataSize = 0;
+  if (encoder == nullptr || !obs_encoder_get_extra_data(encoder, &extraData, &extraDataSize) || extraDataSize == 0) {
+    return false;
+  }
+
+  if (packet->size >= extraDataSize && memcmp(packet->data, extraData, extraDataSize) == 0) {
+    return false;
+  }
+
+  keyframeBuffer.assign(extraData, extraData + extraDataSize);
+  keyframeBuffer.insert(keyframeBuffer.end(), packet->data, packet->data + packet->size);
+  RtpPacketizer::CreatePacket(out, packet, keyframeBuffer);
+  return true;
+}
+
+/**
+ * Hand a packet to the pull rings or the primary sink, then to every
+ * subscriber. Each consumer takes its own reference, so the payload is
+ * shared rather than copied.
+ */
+void StreamOutputInternal::Dispatch(encoder_packet *packet) {
+  if (pullRings[0]) {
+    PushPull(packet);
+  } else if (sink) {
+    sink->Push(packet);
+  }
+
+  std::lock_guard<std::mutex> lock(subscribersMutex);
+  if (packet->type == OBS_ENCODER_VIDEO) {
+    CacheVideo(packet);
+  }
+  for (auto &subscriber : subscribers) {
+    subscriber->Push(packet);
+  }
+}
+
+/**
+ * Keep a reference to the video packets since the last keyframe, which is
+ * what a new subscriber needs to start decoding right away. Called with the
+ * subscriber lock held. A group of pictures longer than maxCachedPackets is
+ * not cached, late subscribers then wait for the next keyframe.
+ */
+void StreamOutputInternal::CacheVideo(encoder_packet *packet) {
+  if (packet->keyframe) {
+    ClearCache();
+  } else if (videoCache.empty() || videoCache.size() >= maxCachedPackets) {
+    ClearCache();
+    return;
+  }
+
+  encoder_packet packetRef{};
+  obs_encoder_packet_ref(&packetRef, packet);
+  videoCache.push_back(packetRef);
+}
+
+/**
+ * Release the cached video packets. Called with the subscriber lock held.
+ */
+void StreamOutputInternal::ClearCache() {
+  for (auto &packet : videoCache) {
+    obs_encoder_packet_release(&packet);
+  }
+  videoCache.clear();
+}
+
+/**
+ * Add a packet to its track's ring in pull mode. OBS serializes calls to
+ * OnPacket, so this is the single producer of both rings. A full ring drops
+ * the packet, dropped video additionally skips to the next keyframe.
+ */
+void StreamOutputInternal::PushPull(encoder_packet *packet) {
+  size_t track = packet->type == OBS_ENCODER_VIDEO ? OBS_ENCODER_VIDEO : OBS_ENCODER_AUDIO;
+
+  if (track == OBS_ENCODER_VIDEO && pullWaitForKeyframe) {
+    if (!packet->keyframe) {
+      pullDroppedPackets++;
+      pullDroppedBytes += packet->size;
+      return;
+    }
+    pullWaitForKeyframe = false;
+  }
+
+  encoder_packet packetRef{};
+  obs_encoder_packet_ref(&packetRef, packet);
+  if (!pullRings[track]->Push(packetRef)) {
+    obs_encoder_packet_release(&packetRef);
+    pullDroppedPackets++;
+    pullDroppedBytes += packet->size;
+    if (track == OBS_ENCODER_VIDEO) pullWaitForKeyframe = true;
+    return;
+  }
+
+  // Only wake up Node.js if the reader found this track empty.
+  if (readerWaiting[track].exchange(false) && static_cast<napi_threadsafe_function>(session->onReadable) != nullptr) {
+    session->onReadable.NonBlockingCall([track](Napi::Env env, Napi::Function jsCallback) {
+      jsCallback.Call( {Napi::Number::New(env, track)} );
     });
   }
 }
 
 /**
- * Update callbacks if they have changed.
+ * Release every packet waiting in the pull rings. Called on the Node.js
+ * thread, the ring's consumer, while the output thread is not pushing.
+ */
+void StreamOutputInternal::ClearPull() {
+  encoder_packet packet{};
+  for (auto &ring : pullRings) {
+    while (ring && ring->Pop(packet)) {
+      obs_encoder_packet_release(&packet);
+    }
+  }
+  pullWaitForKeyframe = false;
+}
+
+/**
+ * Take up to maxPackets packets from a track's ring on the Node.js thread.
+ * If the ring is empty the reader is marked as waiting so the next packet
+ * triggers onReadable, checking the ring again afterwards closes the race
+ * with a packet pushed in between.
+ */
+void StreamOutputInternal::PopPull(size_t track, size_t maxPackets, std::vector<encoder_packet> &packets) {
+  auto &ring = pullRings[track];
+  encoder_packet packet{};
+
+  while (packets.size() < maxPackets && ring->Pop(packet)) {
+    packets.push_back(packet);
+  }
+
+  if (packets.empty()) {
+    readerWaiting[track] = true;
+    if (!ring->Empty() && readerWaiting[track].exchange(false)) {
+      while (packets.size() < maxPackets && ring->Pop(packet)) {
+        packets.push_back(packet);
+      }
+    }
+  }
+}
+
+/**
+ * Report packets dropped by the backpressure policy to OBS.
+ */
+int StreamOutputInternal::GetDroppedFrames(void* data) {
+  auto output = (StreamOutputInternal*)(data);
+  uint64_t droppedPackets = output->pullDroppedPackets;
+  if (output->sink) droppedPackets += output->sink->GetDroppedPackets();
+  return (int)droppedPackets;
+}
+
+/**
+ * Procedure handler returning the queue statistics.
+ */
+void StreamOutputInternal::GetStats(void* data, calldata_t* cd) {
+  auto output = (StreamOutputInternal*)(data);
+  uint64_t droppedPackets = output->pullDroppedPackets;
+  uint64_t droppedBytes = output->pullDroppedBytes;
+  size_t queuedPackets = 0;
+  if (output->sink) {
+    droppedPackets += output->sink->GetDroppedPackets();
+    droppedBytes += output->sink->GetDroppedBytes();
+    queuedPackets += output->sink->GetQueuedPackets();
+  }
+  for (auto &ring : output->pullRings) {
+    if (ring) queuedPackets += ring->Size();
+  }
+
+  calldata_set_int(cd, "dropped_packets", (long long)droppedPackets);
+  calldata_set_int(cd, "dropped_bytes", (long long)droppedBytes);
+  calldata_set_int(cd, "queued_packets", (long long)queuedPackets);
+}
+
+/**
+ * Procedure handler reading packets of one track in pull mode.
+ */
+void StreamOutputInternal::ReadPackets(void* data, calldata_t* cd) {
+  auto output = (StreamOutputInternal*)(data);
+  long long track = calldata_int(cd, "track");
+  long long maxPackets = calldata_int(cd, "max_packets");
+  auto packets = static_cast<std::vector<encoder_packet> *>(calldata_ptr(cd, "packets"));
+
+  if (packets == nullptr || maxPackets <= 0 || (track != OBS_ENCODER_AUDIO && track != OBS_ENCODER_VIDEO)) return;
+  if (!output->pullRings[track]) return;
+
+  output->PopPull(track, maxPackets, *packets);
+}
+
+/**
+ * Procedure handler adding a subscriber. The sink starts receiving packets
+ * from the output thread immediately, see PacketSink for joining at a
+ * keyframe. With replay set it first receives the cached video since the
+ * last keyframe, so it can start without waiting for the next one.
+ */
+void StreamOutputInternal::AddSubscriber(void* data, calldata_t* cd) {
+  auto output = (StreamOutputInternal*)(data);
+  auto subscriber = static_cast<std::shared_ptr<PacketSink> *>(calldata_ptr(cd, "sink"));
+  if (subscriber == nullptr || !*subscriber) return;
+
+  std::lock_guard<std::mutex> lock(output->subscribersMutex);
+  if (calldata_bool(cd, "replay")) {
+    for (auto &packet : output->videoCache) {
+      (*subscriber)->Push(&packet);
+    }
+  }
+  output->subscribers.push_back(*subscriber);
+}
+
+/**
+ * Procedure handler removing a subscriber. Once this returns the output
+ * thread no longer touches the sink.
  */
-void StreamOutputInternal::Update(void* data, obs_data_t* settings) {
+void StreamOutputInternal::RemoveSubscriber(void* data, calldata_t* cd) {
   auto output = (StreamOutputInternal*)(data);
-  long long onData = obs_data_get_int(settings, "onData");
+  auto subscriber = static_cast<std::shared_ptr<PacketSink> *>(calldata_ptr(cd, "sink"));
+  if (subscriber == nullptr) return;
 
-  output->onData = reinterpret_cast<Napi::ThreadSafeFunction *>(onData);
+  std::lock_guard<std::mutex> lock(output->subscribersMutex);
+  auto &subscribers = output->subscribers;
+  subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), *subscriber), subscribers.end());
 }
@@ -1,20 +1,27 @@
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <napi.h>
 #include <obs.h>
+#include "PacketSink.h"
+#include "RtpPacketizer.h"
+#include "SpscRing.h"
+#include "StreamOutputSession.h"
 #include "StreamOutput.h"
 
 class StreamOutputInternal {
 public:
+  ~StreamOutputInternal();
+
   static void LoadOutput();
 
+  static obs_output_t *CreateOutput(const std::string &name, std::shared_ptr<StreamOutputSession> session);
+
 private:
-  explicit StreamOutputInternal(
-      obs_output_t *output,
-      Napi::ThreadSafeFunction* onData,
-      Napi::ThreadSafeFunction* onStop,
-      Napi::ObjectReference* jsThis,
-      Napi::AsyncContext* asyncContext
-    );
+  StreamOutputInternal(obs_output_t *output, std::shared_ptr<StreamOutputSession> session);
 
   static const char* GetName([[maybe_unused]] void* typeData);
   static void* Create(obs_data_t *settings, obs_output_t *output);
@@ -22,7 +29,19 @@ private:
   static bool Start([[maybe_unused]] void* data);
   static void Stop(void* data, [[maybe_unused]] uint64_t ts);
   static void OnPacket(void* data, encoder_packet *packet);
-  static void Update(void* data, obs_data_t* settings);
+  static int GetDroppedFrames(void* data);
+  static void GetStats(void* data, calldata_t* cd);
+  static void ReadPackets(void* data, calldata_t* cd);
+  static void AddSubscriber(void* data, calldata_t* cd);
+  static void RemoveSubscriber(void* data, calldata_t* cd);
+
+  void Dispatch(encoder_packet *packet);
+  bool AddParameterSets(encoder_packet *packet, encoder_packet *out);
+  void CacheVideo(encoder_packet *packet);
+  void ClearCache();
+  void PushPull(encoder_packet *packet);
+  void ClearPull();
+  void PopPull(size_t track, size_t maxPackets, std::vector<encoder_packet> &packets);
 
   static constexpr char const* outputId = "stream_output";
   static constexpr char const* outputName = "Stream Output";
@@ -35,12 +54,40 @@ private:
     .destroy = &Destroy,
     .start = &Start,
     .stop = &Stop,
-    .encoded_packet = &OnPacket
+    .encoded_packet = &OnPacket,
+    .get_dropped_frames = &GetDroppedFrames
   };
 
-  Napi::ThreadSafeFunction* onData;
-  Napi::ThreadSafeFunction* onStop;
-  Napi::ObjectReference* jsThis;
-  Napi::AsyncContext* asyncContext;
+  // Handed from CreateOutput to Create.
+  static thread_local std::shared_ptr<StreamOutputSession> pendingSession;
+
+  std::shared_ptr<StreamOutputSession> session;
   obs_output_t *output;
+
+  // The queue for the session's onData callback, created when the output
+  // starts and null in pull mode.
+  std::shared_ptr<PacketSink> sink;
+
+  // Consumers added while the output exists. The output thread holds the
+  // mutex while pushing, so once a subscriber is removed it is guaranteed
+  // to receive no more packets.
+  std::mutex subscribersMutex;
+  std::vector<std::shared_ptr<PacketSink>> subscribers;
+
+  // Video since the last keyframe, replayed to new subscribers. Guarded by
+  // the subscriber lock.
+  static constexpr size_t maxCachedPackets = 1024;
+  std::vector<encoder_packet> videoCache;
+
+  // Scratch space for keyframes with parameter sets, output thread only.
+  std::vector<uint8_t> keyframeBuffer;
+
+  // Pull mode state, one ring per track indexed by the packet type.
+  std::unique_ptr<SpscRing<encoder_packet>> pullRings[2];
+  std::atomic<bool> readerWaiting[2] = {false, false};
+  std::atomic<uint64_t> pullDroppedPackets{0};
+  std::atomic<uint64_t> pullDroppedBytes{0};
+  bool pullWaitForKeyframe = false;
+
+  std::unique_ptr<RtpPacketizer> packetizer;
 };
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <napi.h>
+#include "PacketQueue.h"
+
+/**
+ * The callbacks and options of one StreamOutput, shared between the Node.js
+ * object and the OBS output it created. Whichever of the two is destroyed
+ * last releases the thread safe functions, so the callbacks stay valid
+ * exactly as long as OBS can call them and never keep the event loop alive
+ * after that.
+ */
+struct StreamOutputSession {
+  StreamOutputSession() = default;
+  StreamOutputSession(const StreamOutputSession &) = delete;
+  StreamOutputSession &operator=(const StreamOutputSession &) = delete;
+
+  ~StreamOutputSession() {
+    Release(onData);
+    Release(onStop);
+    Release(onReadable);
+  }
+
+  /**
+   * Release a thread safe function if it was created and reset the handle.
+   */
+  static void Release(Napi::ThreadSafeFunction &function) {
+    if (static_cast<napi_threadsafe_function>(function) != nullptr) {
+      function.Release();
+      function = Napi::ThreadSafeFunction();
+    }
+  }
+
+  Napi::ThreadSafeFunction onData;
+  Napi::ThreadSafeFunction onStop;
+  Napi::ThreadSafeFunction onReadable;
+
+  bool zeroCopy = false;
+  size_t batchMaxPackets = 1;
+  uint64_t batchMaxLatencyUs = 0;
+  size_t queueCapacity = 0;
+  BackpressurePolicy queuePolicy = BackpressurePolicy::Block;
+  size_t pullCapacity = 0;
+  size_t rtpMtu = 0;
+  bool rtpAudio = false;
+  uint32_t rtpAudioSsrc = 0;
+  uint8_t rtpAudioPayloadType = 120;
+};
@@ -1,5 +1,9 @@
 #include "Studio.h"
+#include <algorithm>
+#include <vector>
+#include "Scene.h"
 #include "Settings.h"
+#include "Source.h"
 #include "StreamOutputInternal.h"
 #include "utils.h"
 #include <obs.h>
@@ -166,11 +170,167 @@ Napi::Value Studio::ResetAudio(const Napi::CallbackInfo &info) {
   return env.Null();
 }
 
+/**
+ * Build sources, scenes and their items from a scene description, the JSON
+ * document OBS saves scene collections as: {"sources": [...]} with every
+ * source as written by obs_save_source. Scenes find the sources of their
+ * items by name, so names have to be unique among the sources of OBS.
+ * Returns {sources, scenes} objects of the loaded objects by name.
+ */
+Napi::Value Studio::LoadScene(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_data_t *document = obs_data_create_from_json(info[0].ToString().Utf8Value().c_str());
+  if (document == nullptr) {
+    Napi::Error::New(env, "Could not parse scene description")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<obs_source_t *> loaded;
+  obs_data_array_t *sourceArray = obs_data_get_array(document, "sources");
+  for (size_t i = 0, count = obs_data_array_count(sourceArray); i < count; i++) {
+    obs_data_t *sourceData = obs_data_array_item(sourceArray, i);
+    obs_source_t *source = obs_load_source(sourceData);
+    if (source != nullptr) {
+      loaded.push_back(source);
+    } else {
+      blog(LOG_WARNING, "Could not load source '%s'", obs_data_get_string(sourceData, "name"));
+    }
+    obs_data_release(sourceData);
+  }
+  obs_data_array_release(sourceArray);
+  obs_data_release(document);
+
+  // Like obs_load_sources, load scenes only once every source exists.
+  for (obs_source_t *source : loaded) {
+    obs_source_load(source);
+  }
+
+  Napi::Object sources = Napi::Object::New(env);
+  Napi::Object scenes = Napi::Object::New(env);
+  for (obs_source_t *source : loaded) {
+    obs_scene_t *scene = obs_scene_from_source(source);
+    if (scene != nullptr) {
+      scenes.Set(obs_source_get_name(source), Scene::FromReference(env, scene));
+    } else {
+      sources.Set(obs_source_get_name(source), Source::FromReference(env, source));
+    }
+    obs_source_release(source);
+  }
+
+  Napi::Object handles = Napi::Object::New(env);
+  handles.Set("sources", sources);
+  handles.Set("scenes", scenes);
+  return handles;
+}
+
+static void CollectSources(obs_scene_t *scene, std::vector<obs_source_t *> &sources);
+
+static bool CollectItemSource([[maybe_unused]] obs_scene_t *scene, obs_sceneitem_t *item, void *param) {
+  auto &sources = *static_cast<std::vector<obs_source_t *> *>(param);
+  obs_source_t *source = obs_sceneitem_get_source(item);
+
+  if (std::find(sources.begin(), sources.end(), source) != sources.end()) return true;
+
+  obs_scene_t *nested = obs_scene_from_source(source);
+  if (nested != nullptr) {
+    CollectSources(nested, sources);
+  } else {
+    sources.push_back(source);
+  }
+  return true;
+}
+
+/**
+ * Collect the sources shown by a scene, nested scenes included, followed by
+ * the scene itself.
+ */
+static void CollectSources(obs_scene_t *scene, std::vector<obs_source_t *> &sources) {
+  obs_scene_enum_items(scene, &CollectItemSource, &sources);
+  sources.push_back(obs_scene_get_source(scene));
+}
+
+/**
+ * Save a scene, every source it shows and its nested scenes as a scene
+ * description that LoadScene builds them from again.
+ */
+Napi::Value Studio::SaveScene(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be a scene object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *source = nullptr;
+  try {
+    source = Source::Unwrap(info[0].ToObject().Get("source").ToObject())->sourceReference;
+  } catch (const std::exception &e) {
+    Napi::TypeError::New(env, "First argument must be a scene object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_scene_t *scene = obs_scene_from_source(source);
+  if (scene == nullptr) {
+    Napi::TypeError::New(env, "First argument must be a scene object")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<obs_source_t *> sources;
+  CollectSources(scene, sources);
+
+  obs_data_array_t *sourceArray = obs_data_array_create();
+  for (obs_source_t *source : sources) {
+    obs_data_t *sourceData = obs_save_source(source);
+    obs_data_array_push_back(sourceArray, sourceData);
+    obs_data_release(sourceData);
+  }
+
+  obs_data_t *document = obs_data_create();
+  obs_data_set_array(document, "sources", sourceArray);
+  Napi::String json = Napi::String::New(env, obs_data_get_json(document));
+  obs_data_array_release(sourceArray);
+  obs_data_release(document);
+
+  return json;
+}
+
+/**
+ * Remove the source of an output channel, deactivating it and taking its
+ * audio out of the mix.
+ */
+Napi::Value Studio::ClearOutputChannel(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber() || info[0].As<Napi::Number>().Int64Value() < 0 ||
+      info[0].As<Napi::Number>().Int64Value() >= MAX_CHANNELS) {
+    Napi::RangeError::New(env, "First argument must be a channel from 0 to " + std::to_string(MAX_CHANNELS - 1))
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_set_output_source(info[0].As<Napi::Number>().Uint32Value(), nullptr);
+  return env.Null();
+}
+
 Napi::Object Studio::Init(Napi::Env env, Napi::Object exports) {
   Napi::Object studioObject = Napi::Object::New(env);
   studioObject.Set(Napi::String::New(env, "startup"), Napi::Function::New(env, Startup));
   studioObject.Set(Napi::String::New(env, "resetVideo"), Napi::Function::New(env, ResetVideo));
   studioObject.Set(Napi::String::New(env, "resetAudio"), Napi::Function::New(env, ResetAudio));
+  studioObject.Set(Napi::String::New(env, "loadScene"), Napi::Function::New(env, LoadScene));
+  studioObject.Set(Napi::String::New(env, "saveScene"), Napi::Function::New(env, SaveScene));
+  studioObject.Set(Napi::String::New(env, "clearOutputChannel"), Napi::Function::New(env, ClearOutputChannel));
 
   exports.Set(Napi::String::New(env, "Studio"), studioObject);
   return exports;
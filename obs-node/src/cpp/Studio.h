@@ -8,6 +8,9 @@ namespace Studio {
   Napi::Value Shutdown(const Napi::CallbackInfo &info);
   Napi::Value ResetVideo(const Napi::CallbackInfo &info);
   Napi::Value ResetAudio(const Napi::CallbackInfo &info);
+  Napi::Value LoadScene(const Napi::CallbackInfo &info);
+  Napi::Value SaveScene(const Napi::CallbackInfo &info);
+  Napi::Value ClearOutputChannel(const Napi::CallbackInfo &info);
 
   Napi::Object Init(Napi::Env env, Napi::Object exports);
 
@@ -26,11 +26,11 @@ VideoEncoder::VideoEncoder(const Napi::CallbackInfo &info) : ObjectWrap(info) {
 
   obs_data_t *settings = obs_encoder_defaults(encoderId.c_str());
   if (info[2].IsObject()) {
-    DataFromObject(env, info[2].ToObject(), settings);
+    SettingsMarshaller::Apply(info[2].ToObject(), settings, SettingsKind::Encoder, encoderId);
   }
 
   encoderReference = obs_video_encoder_create(encoderId.c_str(), name.c_str(), settings, nullptr);
-  obs_encoder_set_video(encoderReference, obs_get_video());
+  obs_data_release(settings);
 
   if (encoderReference == nullptr) {
     Napi::TypeError::New(env, "Could not create encoder object")
@@ -38,7 +38,7 @@ VideoEncoder::VideoEncoder(const Napi::CallbackInfo &info) : ObjectWrap(info) {
     return;
   }
 
-  obs_encoder_update(encoderReference, settings);
+  obs_encoder_set_video(encoderReference, obs_get_video());
 }
 
 VideoEncoder::~VideoEncoder() {
@@ -62,9 +62,10 @@ Napi::Value VideoEncoder::UpdateSettings(const Napi::CallbackInfo &info) {
     return env.Null();
   }
 
-  DataFromObject(env, info[0].ToObject(), settings);
+  SettingsMarshaller::Apply(info[0].ToObject(), settings, SettingsKind::Encoder, encoderId);
 
   obs_encoder_update(encoderReference, settings);
+  obs_data_release(settings);
   return env.Null();
 }
 
@@ -0,0 +1,304 @@
+#include "View.h"
+#include <cstring>
+#include <graphics/vec4.h>
+#include <util/platform.h>
+#include "Source.h"
+#include "VideoEncoder.h"
+
+View::View(const Napi::CallbackInfo &info) : ObjectWrap(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2) {
+    Napi::TypeError::New(env, "Wrong number of arguments")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "First argument must be a string")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!info[1].IsObject()) {
+    Napi::TypeError::New(env, "Second argument must be an object")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  name = info[0].ToString().Utf8Value();
+  Napi::Object options = info[1].ToObject();
+  Napi::Value widthValue = options.Get("width");
+  Napi::Value heightValue = options.Get("height");
+  Napi::Value divisorValue = options.Get("fpsDivisor");
+
+  if (!widthValue.IsNumber() || !heightValue.IsNumber() ||
+      widthValue.As<Napi::Number>().Int64Value() <= 0 || heightValue.As<Napi::Number>().Int64Value() <= 0) {
+    Napi::TypeError::New(env, "width and height must be positive numbers")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (!divisorValue.IsUndefined() && (!divisorValue.IsNumber() || divisorValue.As<Napi::Number>().Int64Value() <= 0)) {
+    Napi::TypeError::New(env, "fpsDivisor must be a positive number")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  width = widthValue.As<Napi::Number>().Uint32Value();
+  height = heightValue.As<Napi::Number>().Uint32Value();
+  if (divisorValue.IsNumber()) fpsDivisor = divisorValue.As<Napi::Number>().Uint32Value();
+
+  obs_video_info mainVideo = {};
+  if (!obs_get_video_info(&mainVideo)) {
+    Napi::Error::New(env, "Video has to be reset before creating a view")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  baseWidth = mainVideo.base_width;
+  baseHeight = mainVideo.base_height;
+
+  // Encoders convert from RGBA to the format they need when they connect.
+  video_output_info videoInfo = {};
+  videoInfo.name = name.c_str();
+  videoInfo.format = VIDEO_FORMAT_RGBA;
+  videoInfo.fps_num = mainVideo.fps_num;
+  videoInfo.fps_den = mainVideo.fps_den * fpsDivisor;
+  videoInfo.width = width;
+  videoInfo.height = height;
+  videoInfo.cache_size = 16;
+  videoInfo.colorspace = mainVideo.colorspace;
+  videoInfo.range = mainVideo.range;
+
+  if (video_output_open(&video, &videoInfo) != VIDEO_OUTPUT_SUCCESS) {
+    video = nullptr;
+    Napi::Error::New(env, "Could not open video output")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  obs_enter_graphics();
+  texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+  for (gs_stagesurf_t *&surface : stageSurfaces) {
+    surface = gs_stagesurface_create(width, height, GS_RGBA);
+  }
+  obs_leave_graphics();
+
+  view = obs_view_create();
+  obs_add_tick_callback(&View::Tick, this);
+  ticking = true;
+}
+
+View::~View() {
+  Destroy();
+}
+
+/**
+ * Stop rendering and free the view. Encoders bound to it have to be stopped
+ * before.
+ */
+void View::Destroy() {
+  if (!obs_initialized()) return;
+
+  // Once removed, the tick callback is not running and will not run again.
+  if (ticking) obs_remove_tick_callback(&View::Tick, this);
+  ticking = false;
+
+  if (view != nullptr) {
+    // Deactivates and releases the sources of every channel.
+    obs_view_destroy(view);
+    view = nullptr;
+  }
+
+  if (video != nullptr) {
+    video_output_close(video);
+    video = nullptr;
+  }
+
+  obs_enter_graphics();
+  gs_texrender_destroy(texrender);
+  texrender = nullptr;
+  for (gs_stagesurf_t *&surface : stageSurfaces) {
+    gs_stagesurface_destroy(surface);
+    surface = nullptr;
+  }
+  obs_leave_graphics();
+}
+
+void View::Tick(void *param, [[maybe_unused]] float seconds) {
+  auto *self = static_cast<View *>(param);
+
+  if (self->tickCount++ % self->fpsDivisor != 0) return;
+  // Nothing is rendered until an encoder is connected.
+  if (!video_output_active(self->video)) return;
+
+  obs_enter_graphics();
+  self->Render();
+  obs_leave_graphics();
+}
+
+/**
+ * Pass on the frame staged on the previous render and stage the next one.
+ * Called in the graphics context.
+ */
+void View::Render() {
+  uint32_t previous = 1 - stageIndex;
+  if (staged[previous]) {
+    Output(previous);
+    staged[previous] = false;
+  }
+
+  gs_texrender_reset(texrender);
+  if (!gs_texrender_begin(texrender, width, height)) return;
+
+  vec4 clearColor;
+  vec4_zero(&clearColor);
+  gs_clear(GS_CLEAR_COLOR, &clearColor, 0.0f, 0);
+  gs_ortho(0.0f, static_cast<float>(baseWidth), 0.0f, static_cast<float>(baseHeight), -100.0f, 100.0f);
+
+  gs_blend_state_push();
+  gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+  obs_view_render(view);
+  gs_blend_state_pop();
+  gs_texrender_end(texrender);
+
+  gs_stage_texture(stageSurfaces[stageIndex], gs_texrender_get_texture(texrender));
+  stagedAt[stageIndex] = os_gettime_ns();
+  staged[stageIndex] = true;
+  stageIndex = previous;
+}
+
+/**
+ * Copy a staged frame into the video output. Called in the graphics context.
+ */
+void View::Output(uint32_t index) {
+  uint8_t *data = nullptr;
+  uint32_t linesize = 0;
+  if (!gs_stagesurface_map(stageSurfaces[index], &data, &linesize)) return;
+
+  video_frame frame = {};
+  if (video_output_lock_frame(video, &frame, 1, stagedAt[index])) {
+    if (frame.linesize[0] == linesize) {
+      memcpy(frame.data[0], data, static_cast<size_t>(linesize) * height);
+    } else {
+      for (uint32_t y = 0; y < height; y++) {
+        memcpy(frame.data[0] + y * frame.linesize[0], data + y * linesize, width * 4);
+      }
+    }
+    video_output_unlock_frame(video);
+    framesRendered++;
+  } else {
+    // The encoders are behind and the frame cache is full.
+    framesDropped++;
+  }
+
+  gs_stagesurface_unmap(stageSurfaces[index]);
+}
+
+/**
+ * Show the source passed in on a channel of the view, or nothing if it is
+ * null. Channels are drawn in order, 0 at the bottom.
+ */
+Napi::Value View::SetSource(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsNumber() || info[0].As<Napi::Number>().Int64Value() < 0 ||
+      info[0].As<Napi::Number>().Int64Value() >= MAX_CHANNELS) {
+    Napi::RangeError::New(env, "First argument must be a channel from 0 to " + std::to_string(MAX_CHANNELS - 1))
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (view == nullptr) {
+    Napi::Error::New(env, "The view has been released")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_source_t *source = nullptr;
+  if (!info[1].IsNull()) {
+    try {
+      source = Source::Unwrap(info[1].ToObject().Get("source").ToObject())->sourceReference;
+    } catch (const std::exception &e) {
+      Napi::TypeError::New(env, "Second argument must be a source object or null")
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  obs_view_set_source(view, info[0].As<Napi::Number>().Uint32Value(), source);
+  return env.Null();
+}
+
+/**
+ * Encode the video of this view with the video encoder passed in. The
+ * encoder must not be in use.
+ */
+Napi::Value View::BindEncoder(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "First argument must be a video encoder")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (video == nullptr) {
+    Napi::Error::New(env, "The view has been released")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_encoder_t *encoder = nullptr;
+  try {
+    encoder = VideoEncoder::Unwrap(info[0].ToObject())->encoderReference;
+  } catch (const std::exception &e) {
+    Napi::TypeError::New(env, "First argument must be a video encoder")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (obs_encoder_active(encoder)) {
+    Napi::Error::New(env, "The encoder is in use")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  obs_encoder_set_video(encoder, video);
+  return env.Null();
+}
+
+/**
+ * Get the number of frames passed to the encoders and dropped because they
+ * fell behind.
+ */
+Napi::Value View::GetStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("framesRendered", Napi::Number::New(env, static_cast<double>(framesRendered)));
+  stats.Set("framesDropped", Napi::Number::New(env, static_cast<double>(framesDropped)));
+  return stats;
+}
+
+/**
+ * Free the view without waiting for it to be collected.
+ */
+Napi::Value View::Release(const Napi::CallbackInfo &info) {
+  Destroy();
+  return info.Env().Null();
+}
+
+Napi::Function View::GetClass(Napi::Env env) {
+  return DefineClass(env, "View", {
+      View::InstanceMethod("setSource", &View::SetSource),
+      View::InstanceMethod("bindEncoder", &View::BindEncoder),
+      View::InstanceMethod("getStats", &View::GetStats),
+      View::InstanceMethod("release", &View::Release)
+  });
+}
+
+Napi::Object View::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set(Napi::String::New(env, "View"), View::GetClass(env));
+  return exports;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <napi.h>
+#include <obs.h>
+
+/**
+ * A video mix of its own, so several independent scenes can be encoded in
+ * one OBS process instead of all sharing the output channels of the main
+ * mix.
+ *
+ * The channels of an obs_view are rendered on the graphics thread, every
+ * fpsDivisor frames of the main mix, into a texture of the size of the view
+ * and passed to a video output opened for the view. Video encoders bound to
+ * the view encode that output instead of the main one. Scenes are laid out
+ * in the base resolution of the main mix and scaled to the size of the view.
+ */
+class View : public Napi::ObjectWrap<View> {
+public:
+  explicit View(const Napi::CallbackInfo &info);
+  ~View() override;
+
+  Napi::Value SetSource(const Napi::CallbackInfo &info);
+  Napi::Value BindEncoder(const Napi::CallbackInfo &info);
+  Napi::Value GetStats(const Napi::CallbackInfo &info);
+  Napi::Value Release(const Napi::CallbackInfo &info);
+
+  static Napi::Function GetClass(Napi::Env env);
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+private:
+  void Destroy();
+  void Render();
+  void Output(uint32_t index);
+  static void Tick(void *param, float seconds);
+
+  std::string name;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t baseWidth = 0;
+  uint32_t baseHeight = 0;
+  uint32_t fpsDivisor = 1;
+
+  obs_view_t *view = nullptr;
+  video_t *video = nullptr;
+  gs_texrender_t *texrender = nullptr;
+  // Frames are staged on one frame and read back on the next, so reading
+  // them does not wait for the GPU.
+  gs_stagesurf_t *stageSurfaces[2] = {nullptr, nullptr};
+  uint64_t stagedAt[2] = {0, 0};
+  bool staged[2] = {false, false};
+  uint32_t stageIndex = 0;
+  bool ticking = false;
+
+  uint64_t tickCount = 0;
+  std::atomic<uint64_t> framesRendered{0};
+  std::atomic<uint64_t> framesDropped{0};
+};
@@ -2,15 +2,23 @@
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   AudioEncoder::Init(env, exports);
+  EventBus::Init(env, exports);
+  LevelMeter::Init(env, exports);
+  MediaPlayer::Init(env, exports);
   Output::Init(env, exports);
   OutputService::Init(env, exports);
   Scene::Init(env, exports);
   SceneItem::Init(env, exports);
   Source::Init(env, exports);
+  SourcePool::Init(env, exports);
   Scene::Init(env, exports);
   StreamOutput::Init(env, exports);
   Studio::Init(env, exports);
   VideoEncoder::Init(env, exports);
+  View::Init(env, exports);
+#ifdef OBS_NODE_BENCHMARKS
+  SettingsBenchmark::Init(env, exports);
+#endif
 
   return exports;
 }
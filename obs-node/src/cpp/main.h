@@ -2,14 +2,22 @@
 
 #include <napi.h>
 #include "AudioEncoder.h"
+#include "EventBus.h"
+#include "LevelMeter.h"
+#include "MediaPlayer.h"
 #include "Output.h"
 #include "OutputService.h"
 #include "Scene.h"
 #include "SceneItem.h"
 #include "Source.h"
+#include "SourcePool.h"
 #include "Scene.h"
 #include "StreamOutput.h"
 #include "Studio.h"
 #include "VideoEncoder.h"
+#include "View.h"
+#ifdef OBS_NODE_BENCHMARKS
+#include "SettingsBenchmark.h"
+#endif
 
 Napi::Object Init(Napi::Env env, Napi::Object exports);
@@ -31,10 +31,31 @@ export interface AudioEncoder {
     use(): void
 }
 
-interface StreamOutputInternal {
+type PacketData = ArrayBuffer | Buffer
+
+// Offsets into the packet metadata array, every packet takes PACKET_META_FIELDS entries.
+export enum PacketMetaField {
+    Pts = 0,
+    Dts,
+    TimebaseNum,
+    TimebaseDen,
+    Type,
+    Keyframe,
+    Priority,
+    TrackIdx,
+}
+export const PACKET_META_FIELDS = 8
+
+interface StreamOutputInternal extends SignalSource {
     new(name: string, settings: {
-        onData: (data: ArrayBuffer, type: number) => void,
-        onStop: () => void
+        onData: (data: PacketData | PacketData[], typeOrMeta: number | Float64Array, meta?: Float64Array) => void,
+        onStop: () => void,
+        zeroCopy?: boolean,
+        batch?: StreamOutputBatchOptions,
+        backpressure?: StreamOutputBackpressureOptions,
+        pull?: StreamOutputPullOptions,
+        onReadable?: (track: number) => void,
+        rtp?: StreamOutputRtpOptions
     })
     setVideoEncoder(encoder: VideoEncoder): void
     setAudioEncoder(encoder: AudioEncoder): void
@@ -45,6 +66,18 @@ interface StreamOutputInternal {
     }): void
     start(): void
     stop(): void
+    getStats(): StreamOutputStats
+    read(track: number, maxPackets: number, meta?: Float64Array): PacketData[]
+    addSubscriber(options: {
+        onData: (data: PacketData | PacketData[], typeOrMeta: number | Float64Array, meta?: Float64Array) => void,
+        zeroCopy?: boolean,
+        instantJoin?: boolean,
+        batch?: StreamOutputBatchOptions,
+        backpressure?: StreamOutputBackpressureOptions
+    }): number
+    removeSubscriber(id: number): boolean
+    getSubscriberStats(id: number): StreamOutputStats
+    release(): void
 }
 
 export interface Output {
@@ -66,15 +99,89 @@ export interface OutputService {
 }
 
 export interface SceneInternal {
-    new(name: string, signalListener: (signal: string) => void)
+    new(name: string)
     addSource(source: Source): SceneItem
     asSource(): SourceInternal
+    applyItemChanges(changes: Float64Array): number
+    getItems(): SceneItem[]
+    findItem(name: string): SceneItem | null
+    getItemById(id: number): SceneItem | null
+    removeAll(): number
 }
 
 export interface SceneItem {
     setTransformInfo(info: TransformInfo): void
     getTransformInfo(): TransformInfo
     remove(): void
+    getId(): number
+    // Animate the item natively on the graphics thread, replacing its running
+    // animation. onComplete gets false if it was stopped, replaced or the item
+    // was removed before the last keyframe.
+    animate(keyframes: SceneItemKeyframe[], options?: AnimationOptions): void
+    stopAnimation(): boolean
+}
+
+export type Easing = "linear" | "easeIn" | "easeOut" | "easeInOut" | "easeOutBack"
+
+// A keyframe sets the properties it lists, time is in milliseconds from the
+// start of the animation. Properties move from the keyframe before that sets
+// them, or from their value when the animation started. Opacity is 0 to 1 and
+// applied by a color filter on the source of the item.
+export interface SceneItemKeyframe {
+    time: number
+    easing?: Easing
+    posX?: number
+    posY?: number
+    scaleX?: number
+    scaleY?: number
+    rot?: number
+    cropLeft?: number
+    cropTop?: number
+    cropRight?: number
+    cropBottom?: number
+    opacity?: number
+}
+
+export interface AnimationOptions {
+    // Easing of keyframes that have none.
+    easing?: Easing
+    onComplete?: (finished: boolean) => void
+}
+
+// Scene item changes of a SceneTransaction, see SceneItemChange in Scene.h. Every
+// change is packed as the change, the scene item ID and its values.
+export enum SceneItemChange {
+    Transform = 0,
+    Crop,
+    Visible,
+    Order,
+    OrderPosition,
+    ScaleFilter,
+}
+
+// obs_order_movement
+export enum OrderMovement {
+    Up = 0,
+    Down,
+    Top,
+    Bottom,
+}
+
+// obs_scale_type
+export enum ScaleFilter {
+    Disable = 0,
+    Point,
+    Bicubic,
+    Bilinear,
+    Lanczos,
+    Area,
+}
+
+export interface CropInfo {
+    left: number
+    top: number
+    right: number
+    bottom: number
 }
 
 export interface TransformInfo {
@@ -90,20 +197,187 @@ export interface TransformInfo {
     boundsY: number
 }
 
-interface SourceInternal {
-    new(sourceId: string, name: string, signalListener: (signal: string) => void, settings: ObsData | undefined)
-    updateSettings(settings: ObsData): void
-    getSettings(): string
+// Signals of sources, scenes and outputs that can be listened to with on(). mute, enable
+// and item_visible/item_locked pass a boolean, volume, audio_sync, audio_mixers,
+// update_flags, stop and reconnect a number, rename and filter_add/filter_remove a name
+// and item_* signals the scene item ID, followed by the new state for item_visible and
+// item_locked. The order matches the signal indices sent by the event bus.
+export const OBS_SIGNALS = [
+    "destroy", "remove", "activate", "deactivate", "show", "hide", "mute", "enable", "rename",
+    "volume", "audio_sync", "audio_mixers", "update_properties", "update_flags",
+    "filter_add", "filter_remove", "reorder_filters",
+    "transition_start", "transition_video_stop", "transition_stop",
+    "media_play", "media_pause", "media_restart", "media_stopped", "media_next", "media_previous", "media_started", "media_ended",
+    "item_add", "item_remove", "reorder", "refresh", "item_visible", "item_locked", "item_select", "item_deselect", "item_transform",
+    "start", "stop", "starting", "stopping", "reconnect", "reconnect_success",
+] as const
+export type ObsSignal = typeof OBS_SIGNALS[number]
+const obsSignals = new Set<string>(OBS_SIGNALS)
+
+// Native objects whose signals can be forwarded through the event bus.
+interface SignalSource {
+    subscribe(signals: ObsSignal[]): void
+    unsubscribe(signals: ObsSignal[]): void
+    getHandle(): number
+}
+
+export interface EventBusStats {
+    postedEvents: number
+    coalescedEvents: number
+    droppedEvents: number
+    deliveredBatches: number
+}
+
+// Events are passed as a flat array of (handle, signal index, payload, state) tuples.
+type EventBusValue = number | boolean | string | undefined
+
+export interface EventBus {
+    start(listener: (events: EventBusValue[]) => void): void
+    stop(): void
+    getStats(): EventBusStats
+}
+
+export interface SourcePoolOptions {
+    // Parked sources of each type and settings kept through idle eviction.
+    minIdle?: number
+    // Parked sources kept in total, the oldest are destroyed beyond this.
+    maxIdle?: number
+    // Milliseconds a source stays parked before it is evicted.
+    idleTimeout?: number
+}
+
+export interface SourcePoolStats {
+    parkedSources: number
+    hits: number
+    misses: number
+    evictions: number
+}
+
+interface SourcePoolInternal {
+    configure(options: SourcePoolOptions): void
+    acquire(sourceId: string, name: string, settings: ObsData | undefined): SourceInternal
+    release(source: Source): void
+    prewarm(sourceId: string, settings: ObsData | undefined, count: number): void
+    evict(): void
+    clear(): void
+    getStats(): SourcePoolStats
+}
+
+// What updateSettings did: nothing changed, the current media was restarted
+// or the changed settings were applied.
+export type SettingsUpdate = "none" | "restart" | "update"
+
+export interface SourceInfo {
+    width: number
+    height: number
+    active: boolean
+    showing: boolean
+    mediaState: MediaState
+    // Milliseconds, as of the last frame.
+    mediaTime: number
+    mediaDuration: number
+    volume: number
+    muted: boolean
+    // Only the settings asked for.
+    settings?: ObsData
+}
+
+export type MediaState = "none" | "playing" | "opening" | "buffering" | "paused" | "stopped" | "ended" | "error"
+
+interface SourceInternal extends SignalSource {
+    new(sourceId: string, name: string, settings: ObsData | undefined)
+    updateSettings(settings: ObsData): SettingsUpdate
+    getSettings(): ObsData
     assignOutputChannel(channel: number): void
     startTransition(): void
     getWidth(): number
     getHeight(): number
+    playPause(pause: boolean): void
+    restart(): void
+    stop(): void
+    setTime(ms: number): void
+    getTime(): number
+    getDuration(): number
+    getState(): MediaState
+    getInfo(settingsKeys?: string[], target?: SourceInfo): SourceInfo
+    setVolume(volume: number): void
+    getVolume(): number
+    setMuted(muted: boolean): void
+    isMuted(): boolean
+    setBalance(balance: number): void
+    getBalance(): number
+    setSyncOffset(ms: number): void
+    getSyncOffset(): number
+    setAudioMixers(mixers: number): void
+    getAudioMixers(): number
+    setEnabled(enabled: boolean): void
+    isEnabled(): boolean
+    addFilter(filterId: string, name: string, settings: ObsData | undefined): SourceInternal
+    removeFilter(name: string): boolean
+    getFilter(name: string): SourceInternal | null
+    getFilters(): string[]
+    setFilterOrder(name: string, movement: FilterMovement): void
 }
 
-export interface Studio {
+export type FilterMovement = "up" | "down" | "top" | "bottom"
+
+// Levels are passed as a flat array of (meter id, peak, RMS, input peak)
+// tuples in dBFS, -Infinity for silence.
+export interface LevelMeter {
+    start(listener: (levels: Float64Array) => void, interval?: number): void
+    stop(): void
+    add(source: Source): number
+    remove(id: number): boolean
+}
+
+export interface MediaPlayerOptions {
+    // Called on every swap, with false if nothing was preloaded and
+    // playback stopped instead.
+    onSwap: (preloaded: boolean) => void
+    // Transition used between items, a cut if not set.
+    transition?: {
+        id?: string
+        // Milliseconds, 0 switches on the frame the previous item ends.
+        duration?: number
+    }
+    // Audio tracks the players are mixed into, a bit mask defaulting to the
+    // first track. Setting the mixers of the slot sources alone leaves the
+    // players they show on the default.
+    mixers?: number
+}
+
+interface MediaPlayerInternal {
+    new(name: string, slots: (ObsData | null)[], options: MediaPlayerOptions)
+    getSource(slot: number): SourceInternal
+    preload(items: (ObsData | null)[]): void
+    hasPreloaded(): boolean
+    skip(): void
+    stop(): void
+    release(): void
+}
+
+interface StudioInternal {
     startup(obsPath: string, locale: string): void
     resetVideo(videoSettings: VideoSettings): void
     resetAudio(audioSettings: AudioSettings): void
+    loadScene(description: string): {
+        sources: { [name: string]: SourceInternal }
+        scenes: { [name: string]: SceneInternal }
+    }
+    saveScene(scene: Scene): string
+    clearOutputChannel(channel: number): void
+}
+
+// The document OBS saves scene collections as, every source as written by
+// obs_save_source. Scenes are sources of id "scene" listing their items in
+// settings.items, by source name.
+export interface SceneDescription {
+    sources: ObsData[]
+}
+
+export interface LoadedScene {
+    sources: { [name: string]: Source }
+    scenes: { [name: string]: Scene }
 }
 
 export interface VideoEncoder {
@@ -112,6 +386,31 @@ export interface VideoEncoder {
     use()
 }
 
+// A video mix of its own, see View.h. Scenes are laid out in the base
+// resolution of the main mix and scaled to width and height, every
+// fpsDivisor frames of the main mix are rendered.
+export interface View {
+    new(name: string, options: ViewOptions)
+    setSource(channel: number, source: Source | null): void
+    // The encoder has to be bound before the output using it starts.
+    bindEncoder(encoder: VideoEncoder): void
+    getStats(): ViewStats
+    // Release the outputs encoding the view first.
+    release(): void
+}
+
+export interface ViewOptions {
+    width: number
+    height: number
+    fpsDivisor?: number
+}
+
+export interface ViewStats {
+    framesRendered: number
+    // Frames dropped because the encoders fell behind.
+    framesDropped: number
+}
+
 export interface VideoSettings {
     baseWidth: number;
     baseHeight: number;
@@ -127,37 +426,210 @@ export interface AudioSettings {
 
 declare interface obs {
     AudioEncoder: AudioEncoder
+    EventBus: EventBus
+    LevelMeter: LevelMeter
+    MediaPlayer: MediaPlayerInternal
     Output: Output
     OutputService: OutputService
     Scene: SceneInternal
     Source: SourceInternal
-    Studio: Studio,
+    SourcePool: SourcePoolInternal
+    Studio: StudioInternal,
     StreamOutput: StreamOutputInternal,
     VideoEncoder: VideoEncoder
+    View: View
+}
+
+export interface StreamOutputBatchOptions {
+    // Deliver once this many packets are queued.
+    maxPackets?: number
+    // Deliver once the oldest queued packet is this old.
+    maxLatencyUs?: number
 }
 
-export class StreamOutput {
+export interface StreamOutputBackpressureOptions {
+    // Maximum number of packets queued for Node.js, 0 for unbounded.
+    capacity: number
+    // What to do when the queue is full, defaults to block.
+    policy?: 'block' | 'dropOldest' | 'dropUntilKeyframe'
+}
+
+export interface StreamOutputPullOptions {
+    // Packets buffered natively per track before new ones are dropped, defaults to 256.
+    capacity?: number
+}
+
+export interface StreamOutputRtpOptions {
+    // Largest RTP payload produced for video, defaults to 1200.
+    mtu?: number
+    // Packetize H.264 video, defaults to true.
+    video?: boolean
+    // Frame Opus audio as complete RTP packets (12 byte header + frame).
+    audio?: {
+        ssrc: number
+        // Defaults to 120, the Opus payload type used by Discord.
+        payloadType?: number
+    }
+}
+
+export interface StreamOutputStats {
+    droppedPackets: number
+    droppedBytes: number
+    queuedPackets: number
+}
+
+export interface StreamOutputOptions {
+    // Pass packets as external Buffers backed by the OBS packet instead of copying them.
+    zeroCopy?: boolean
+    // Collect packets natively and deliver them in batches.
+    batch?: StreamOutputBatchOptions
+    // Bound the native packet queue instead of letting it grow without limit.
+    backpressure?: StreamOutputBackpressureOptions
+    // Let the streams pull packets from native ring buffers instead of pushing them from onData.
+    pull?: StreamOutputPullOptions
+    // Packetize natively. Video packets then hold RTP payloads, each preceded by its
+    // length as a big endian uint16, the last one ends the frame. Audio packets are
+    // complete RTP packets.
+    rtp?: StreamOutputRtpOptions
+    // Called before a packet is pushed to its stream with the packet's metadata at
+    // meta[offset + PacketMetaField.*]. The array is reused, so read it synchronously.
+    // Return false to skip the packet.
+    onPacket?: (data: Buffer, meta: Float64Array, offset: number) => boolean
+}
+
+export interface StreamOutputSubscriberOptions {
+    // Pass packets as external Buffers backed by the OBS packet instead of copying them.
+    zeroCopy?: boolean
+    // Start with the video since the last keyframe instead of waiting for the next one,
+    // defaults to true.
+    instantJoin?: boolean
+    // Collect packets natively and deliver them in batches.
+    batch?: StreamOutputBatchOptions
+    // Bound the subscriber's queue. Subscribers cannot use the block policy, a slow
+    // subscriber must not hold up the output.
+    backpressure?: StreamOutputBackpressureOptions
+}
+
+// Track numbers match the OBS encoder type of the packets.
+const AUDIO_TRACK = 0
+const VIDEO_TRACK = 1
+const PULL_CHUNK_PACKETS = 16
+
+// Zero copy packets already arrive as Buffers backed by the OBS packet.
+function toBuffer(data: PacketData): Buffer {
+    return Buffer.isBuffer(data) ? data : Buffer.from(data)
+}
+
+// Call fn for every packet passed to an onData callback, which receives either a
+// single packet with its type and metadata or a batch with the metadata of all packets.
+function forEachPacket(data: PacketData | PacketData[], typeOrMeta: number | Float64Array, meta: Float64Array | undefined,
+                       fn: (data: PacketData, meta: Float64Array, offset: number) => void): void {
+    if (Array.isArray(data)) {
+        const batchMeta = typeOrMeta as Float64Array
+        for (let i = 0; i < data.length; i++) fn(data[i], batchMeta, i * PACKET_META_FIELDS)
+    } else {
+        fn(data, meta as Float64Array, 0)
+    }
+}
+
+// Another consumer of a StreamOutput's packets with its own streams and queue. It
+// starts at a video keyframe, so it can be added while the output is running.
+export class StreamOutputSubscriber {
+    public readonly id: number
+    public videoStream = new Readable({read: () => {}})
+    public audioStream = new Readable({read: () => {}})
+
+    constructor(private internalOutput: StreamOutputInternal, options: StreamOutputSubscriberOptions = {}) {
+        this.id = internalOutput.addSubscriber({
+            onData: this.onData.bind(this),
+            zeroCopy: options.zeroCopy ?? true,
+            instantJoin: options.instantJoin,
+            batch: options.batch,
+            backpressure: options.backpressure,
+        })
+    }
+
+    private onData(data: PacketData | PacketData[], typeOrMeta: number | Float64Array, meta?: Float64Array): void {
+        forEachPacket(data, typeOrMeta, meta, (packet, packetMeta, offset) => {
+            if (packetMeta[offset + PacketMetaField.Type] === AUDIO_TRACK) this.audioStream.push(toBuffer(packet))
+            else this.videoStream.push(toBuffer(packet))
+        })
+    }
+
+    getStats(): StreamOutputStats {
+        return this.internalOutput.getSubscriberStats(this.id)
+    }
+
+    // Stop receiving packets and end both streams.
+    remove(): void {
+        if (!this.internalOutput.removeSubscriber(this.id)) return
+        this.videoStream.push(null)
+        this.audioStream.push(null)
+    }
+}
+
+export class StreamOutput extends EventEmitter {
     private internalOutput: StreamOutputInternal
-    public videoStream = new Readable({
-        read() {}
-    })
-    public audioStream = new Readable({
-        read() {}
-    })
+    private readonly onPacket?: (data: Buffer, meta: Float64Array, offset: number) => boolean
+    private readonly pullMeta = new Float64Array(PULL_CHUNK_PACKETS * PACKET_META_FIELDS)
+    public videoStream: Readable
+    public audioStream: Readable
+
+    constructor(name: string, options: StreamOutputOptions = {}) {
+        super()
+        this.onPacket = options.onPacket
+        const pull = options.pull !== undefined
+        this.videoStream = new Readable({
+            read: pull ? () => this.pull(VIDEO_TRACK) : () => {}
+        })
+        this.audioStream = new Readable({
+            read: pull ? () => this.pull(AUDIO_TRACK) : () => {}
+        })
 
-    constructor(name: string) {
         this.internalOutput = new obsInstance.StreamOutput(name, {
             onData: this.onData.bind(this),
             onStop: this.onStop.bind(this),
+            zeroCopy: options.zeroCopy ?? true,
+            batch: options.batch,
+            backpressure: options.backpressure,
+            pull: options.pull,
+            onReadable: this.pull.bind(this),
+            rtp: options.rtp,
         })
+        forwardSignals(this, this.internalOutput)
+    }
+
+    // Drain a track's ring until it is empty or the stream buffer is full. An
+    // empty read arms onReadable, which calls back in here once data arrives.
+    private pull(track: number): void {
+        const stream = track === AUDIO_TRACK ? this.audioStream : this.videoStream
+        for (;;) {
+            const packets = this.internalOutput.read(track, PULL_CHUNK_PACKETS, this.pullMeta)
+            if (packets.length === 0) return
+
+            let wantsMore = true
+            for (let i = 0; i < packets.length; i++) {
+                const buffer = toBuffer(packets[i])
+                if (this.onPacket && !this.onPacket(buffer, this.pullMeta, i * PACKET_META_FIELDS)) continue
+                wantsMore = stream.push(buffer)
+            }
+            if (!wantsMore) return
+        }
     }
 
     _read(): void {}
     _destroy(): void {}
 
-    onData(data: ArrayBuffer, type: number): void {
-        if (type === 0) this.audioStream.push(Buffer.from(data))
-        else this.videoStream.push(Buffer.from(data))
+    onData(data: PacketData | PacketData[], typeOrMeta: number | Float64Array, meta?: Float64Array): void {
+        forEachPacket(data, typeOrMeta, meta, this.pushPacket.bind(this))
+    }
+
+    private pushPacket(data: PacketData, meta: Float64Array, offset: number): void {
+        const buffer = toBuffer(data)
+        if (this.onPacket && !this.onPacket(buffer, meta, offset)) return
+
+        if (meta[offset + PacketMetaField.Type] === AUDIO_TRACK) this.audioStream.push(buffer)
+        else this.videoStream.push(buffer)
     }
 
     onStop(): void {}
@@ -188,6 +660,57 @@ export class StreamOutput {
     stop(): void {
         this.internalOutput.stop()
     }
+
+    getStats(): StreamOutputStats {
+        return this.internalOutput.getStats()
+    }
+
+    // Add another consumer sharing this output's encoders.
+    addSubscriber(options: StreamOutputSubscriberOptions = {}): StreamOutputSubscriber {
+        return new StreamOutputSubscriber(this.internalOutput, options)
+    }
+
+    // Stop and free the native output and all of its callbacks, then end both streams.
+    // The output cannot be used afterwards.
+    release(): void {
+        this.removeAllListeners()
+        this.internalOutput.release()
+        this.videoStream.push(null)
+        this.audioStream.push(null)
+    }
+}
+
+// Emitters by event bus handle, only while they are subscribed to at least one signal.
+const signalTargets = new Map<number, EventEmitter>()
+let eventBusStarted = false
+
+function dispatchEvents(events: EventBusValue[]): void {
+    for (let i = 0; i < events.length; i += 4) {
+        const target = signalTargets.get(events[i] as number)
+        if (target) target.emit(OBS_SIGNALS[events[i + 1] as number], events[i + 2], events[i + 3])
+    }
+}
+
+// Forward the OBS signals an emitter has listeners for through the event bus, all other
+// signals are filtered natively.
+function forwardSignals(emitter: EventEmitter, native: SignalSource): void {
+    const handle = native.getHandle()
+    let subscribed = 0
+
+    emitter.on("newListener", (event: string | symbol) => {
+        if (typeof event !== "string" || !obsSignals.has(event) || emitter.listenerCount(event) !== 0) return
+        if (!eventBusStarted) {
+            obsInstance.EventBus.start(dispatchEvents)
+            eventBusStarted = true
+        }
+        native.subscribe([event as ObsSignal])
+        if (subscribed++ === 0) signalTargets.set(handle, emitter)
+    })
+    emitter.on("removeListener", (event: string | symbol) => {
+        if (typeof event !== "string" || !obsSignals.has(event) || emitter.listenerCount(event) !== 0) return
+        native.unsubscribe([event as ObsSignal])
+        if (--subscribed === 0) signalTargets.delete(handle)
+    })
 }
 
 export class Source extends EventEmitter {
@@ -196,20 +719,99 @@ export class Source extends EventEmitter {
     constructor(sourceId: string | SourceInternal, name: string, settings?: ObsData) {
         super();
         if (typeof sourceId === "string") {
-            this.source = new obsInstance.Source(sourceId, name, (signal: string) => {
-                console.log(`[${name}] ${signal}`)
-                this.emit(signal)
-            }, settings)
+            this.source = new obsInstance.Source(sourceId, name, settings)
         } else {
             this.source = sourceId
         }
+        forwardSignals(this, this.source)
     }
 
-    updateSettings(settings: ObsData): void {
-        this.source.updateSettings(settings)
+    updateSettings(settings: ObsData): SettingsUpdate {
+        return this.source.updateSettings(settings)
     }
     getSettings(): ObsData {
-        return JSON.parse(this.source.getSettings())
+        return this.source.getSettings()
+    }
+
+    // Snapshot of the source in one native call. Pass the object returned by
+    // the previous call as target to have it refilled when polling.
+    getInfo(settingsKeys?: string[], target?: SourceInfo): SourceInfo {
+        return this.source.getInfo(settingsKeys, target)
+    }
+
+    // Audio is mixed by OBS, the volume is a linear multiplier and the sync
+    // offset is in milliseconds.
+    setVolume(volume: number): void {
+        this.source.setVolume(volume)
+    }
+
+    getVolume(): number {
+        return this.source.getVolume()
+    }
+
+    setMuted(muted: boolean): void {
+        this.source.setMuted(muted)
+    }
+
+    isMuted(): boolean {
+        return this.source.isMuted()
+    }
+
+    setBalance(balance: number): void {
+        this.source.setBalance(balance)
+    }
+
+    getBalance(): number {
+        return this.source.getBalance()
+    }
+
+    setSyncOffset(ms: number): void {
+        this.source.setSyncOffset(ms)
+    }
+
+    getSyncOffset(): number {
+        return this.source.getSyncOffset()
+    }
+
+    setAudioMixers(mixers: number): void {
+        this.source.setAudioMixers(mixers)
+    }
+
+    getAudioMixers(): number {
+        return this.source.getAudioMixers()
+    }
+
+    setEnabled(enabled: boolean): void {
+        this.source.setEnabled(enabled)
+    }
+
+    isEnabled(): boolean {
+        return this.source.isEnabled()
+    }
+
+    // Filters run in the OBS render and audio threads, e.g. crop_filter,
+    // color_filter, compressor_filter or limiter_filter. A filter is a
+    // Source itself, its settings are updated and it is enabled through it.
+    addFilter(filterId: string, name: string, settings?: ObsData): Source {
+        return new Source(this.source.addFilter(filterId, name, settings), name)
+    }
+
+    removeFilter(name: string): boolean {
+        return this.source.removeFilter(name)
+    }
+
+    getFilter(name: string): Source | null {
+        const filter = this.source.getFilter(name)
+        return filter ? new Source(filter, name) : null
+    }
+
+    // Names of the filters in the order they are applied.
+    getFilters(): string[] {
+        return this.source.getFilters()
+    }
+
+    setFilterOrder(name: string, movement: FilterMovement): void {
+        this.source.setFilterOrder(name, movement)
     }
 
     assignOutputChannel(channel: number): void {
@@ -223,6 +825,40 @@ export class Source extends EventEmitter {
     getHeight(): number {
         return this.source.getHeight()
     }
+
+    // Media controls of sources such as ffmpeg_source. Times are in
+    // milliseconds, the getters are refreshed natively once per frame.
+    play(): void {
+        this.source.playPause(false)
+    }
+
+    pause(): void {
+        this.source.playPause(true)
+    }
+
+    restart(): void {
+        this.source.restart()
+    }
+
+    stop(): void {
+        this.source.stop()
+    }
+
+    seek(ms: number): void {
+        this.source.setTime(ms)
+    }
+
+    getTime(): number {
+        return this.source.getTime()
+    }
+
+    getDuration(): number {
+        return this.source.getDuration()
+    }
+
+    getState(): MediaState {
+        return this.source.getState()
+    }
 }
 
 export class Transition extends Source {
@@ -234,11 +870,7 @@ export class Transition extends Source {
 export class Scene extends Source {
     protected scene: SceneInternal
 
-    constructor(name: string) {
-        const scene = new obsInstance.Scene(name, (signal: string) => {
-            console.log(`[${name}] ${signal}`)
-            this.emit(signal)
-        })
+    constructor(name: string, scene: SceneInternal = new obsInstance.Scene(name)) {
         super(scene.asSource(), name);
         this.scene = scene
     }
@@ -246,10 +878,242 @@ export class Scene extends Source {
     addSource(source: Source): SceneItem {
         return this.scene.addSource(source)
     }
+
+    // Items are the same objects for as long as they are referenced, so
+    // they can be compared and used as map keys.
+    getItems(): SceneItem[] {
+        return this.scene.getItems()
+    }
+
+    // Find the item showing the source with the name passed in.
+    findItem(name: string): SceneItem | null {
+        return this.scene.findItem(name)
+    }
+
+    getItemById(id: number): SceneItem | null {
+        return this.scene.getItemById(id)
+    }
+
+    // Remove every item in the same frame, returns how many were removed.
+    removeAll(): number {
+        return this.scene.removeAll()
+    }
+
+    // Start collecting item changes to be applied together, in one frame.
+    begin(): SceneTransaction {
+        return new SceneTransaction(this.scene)
+    }
+}
+
+// Scene item IDs never change, cache them rather than calling into the addon
+// for every change. Items are wrapped once each, see SceneItem::FromReference.
+const sceneItemIds = new WeakMap<SceneItem, number>()
+
+function getSceneItemId(item: SceneItem): number {
+    let id = sceneItemIds.get(item)
+    if (id === undefined) {
+        id = item.getId()
+        sceneItemIds.set(item, id)
+    }
+    return id
+}
+
+// Item changes of a scene, packed into one array and applied in a single call
+// under the scene lock on commit(). A transaction can be reused after commit.
+export class SceneTransaction {
+    private changes = new Float64Array(64)
+    private length = 0
+
+    constructor(private scene: SceneInternal) {
+    }
+
+    setTransform(item: SceneItem, info: TransformInfo): this {
+        this.push(SceneItemChange.Transform, item, info.posX, info.posY, info.rot, info.scaleX, info.scaleY,
+            info.alignment, info.boundsType, info.boundsAlignment, info.boundsX, info.boundsY)
+        return this
+    }
+
+    setCrop(item: SceneItem, crop: CropInfo): this {
+        this.push(SceneItemChange.Crop, item, crop.left, crop.top, crop.right, crop.bottom)
+        return this
+    }
+
+    setVisible(item: SceneItem, visible: boolean): this {
+        this.push(SceneItemChange.Visible, item, visible ? 1 : 0)
+        return this
+    }
+
+    setOrder(item: SceneItem, movement: OrderMovement): this {
+        this.push(SceneItemChange.Order, item, movement)
+        return this
+    }
+
+    setOrderPosition(item: SceneItem, position: number): this {
+        this.push(SceneItemChange.OrderPosition, item, position)
+        return this
+    }
+
+    setScaleFilter(item: SceneItem, filter: ScaleFilter): this {
+        this.push(SceneItemChange.ScaleFilter, item, filter)
+        return this
+    }
+
+    // Apply the queued changes in order, returns how many were applied.
+    // Changes to items removed from the scene in the meantime are skipped.
+    commit(): number {
+        if (this.length === 0) return 0
+        const applied = this.scene.applyItemChanges(this.changes.subarray(0, this.length))
+        this.length = 0
+        return applied
+    }
+
+    private push(change: SceneItemChange, item: SceneItem, ...values: number[]): void {
+        const needed = this.length + 2 + values.length
+        if (needed > this.changes.length) {
+            const grown = new Float64Array(Math.max(needed, this.changes.length * 2))
+            grown.set(this.changes.subarray(0, this.length))
+            this.changes = grown
+        }
+
+        this.changes[this.length++] = change
+        this.changes[this.length++] = getSceneItemId(item)
+        for (const value of values) {
+            this.changes[this.length++] = value
+        }
+    }
+}
+
+// Plays a queue of media without gaps, see MediaPlayer.h. Every slot is a
+// source holding ffmpeg_source settings, e.g. one for video and one for audio.
+export class MediaPlayer {
+    private player: MediaPlayerInternal
+    private sources: Source[]
+
+    constructor(name: string, slots: (ObsData | null)[], options: MediaPlayerOptions) {
+        this.player = new obsInstance.MediaPlayer(name, slots, options)
+        this.sources = slots.map((_, slot) => new Source(this.player.getSource(slot), `${name} ${slot}`))
+    }
+
+    getSource(slot: number): Source {
+        return this.sources[slot]
+    }
+
+    // Open the next item while the current one plays, one settings object
+    // per slot.
+    preload(items: (ObsData | null)[]): void {
+        this.player.preload(items)
+    }
+
+    hasPreloaded(): boolean {
+        return this.player.hasPreloaded()
+    }
+
+    skip(): void {
+        this.player.skip()
+    }
+
+    stop(): void {
+        this.player.stop()
+    }
+
+    // Stop playing and free the players without waiting for them to be
+    // collected. Remove the sources from scenes first, the player cannot be
+    // used afterwards.
+    release(): void {
+        this.player.release()
+    }
+}
+
+let sourcePoolIdleTimeout = 300000
+let sourcePoolTimer: NodeJS.Timeout | null = null
+
+function scheduleSourcePoolEviction(): void {
+    if (sourcePoolTimer) clearInterval(sourcePoolTimer)
+    sourcePoolTimer = setInterval(() => obsInstance.SourcePool.evict(), Math.max(sourcePoolIdleTimeout / 2, 1000))
+    sourcePoolTimer.unref()
+}
+
+// Released sources are reset and parked natively, acquiring a source with the
+// same type and settings hands out a parked one instead of creating it.
+export const SourcePool = {
+    configure(options: SourcePoolOptions): void {
+        obsInstance.SourcePool.configure(options)
+        if (options.idleTimeout !== undefined) {
+            sourcePoolIdleTimeout = options.idleTimeout
+            if (sourcePoolTimer) scheduleSourcePoolEviction()
+        }
+    },
+
+    acquire(sourceId: string, name: string, settings?: ObsData): Source {
+        return new Source(obsInstance.SourcePool.acquire(sourceId, name, settings), name)
+    },
+
+    // The source can not be used after it was released, remove it from its
+    // scenes first.
+    release(source: Source): void {
+        source.removeAllListeners()
+        obsInstance.SourcePool.release(source)
+        if (!sourcePoolTimer) scheduleSourcePoolEviction()
+    },
+
+    prewarm(sourceId: string, settings?: ObsData, count: number = 1): void {
+        obsInstance.SourcePool.prewarm(sourceId, settings, count)
+        if (!sourcePoolTimer) scheduleSourcePoolEviction()
+    },
+
+    clear(): void {
+        obsInstance.SourcePool.clear()
+    },
+
+    getStats(): SourcePoolStats {
+        return obsInstance.SourcePool.getStats()
+    },
 }
 
 export const AudioEncoder = obsInstance.AudioEncoder
+export const EventBus = obsInstance.EventBus
+export const LevelMeter = obsInstance.LevelMeter
 export const Output = obsInstance.Output
 export const OutputService = obsInstance.OutputService
-export const Studio = obsInstance.Studio
+export const Studio = {
+    startup(obsPath: string, locale: string): void {
+        obsInstance.Studio.startup(obsPath, locale)
+    },
+
+    resetVideo(videoSettings: VideoSettings): void {
+        obsInstance.Studio.resetVideo(videoSettings)
+    },
+
+    resetAudio(audioSettings: AudioSettings): void {
+        obsInstance.Studio.resetAudio(audioSettings)
+    },
+
+    // Create every source, scene and scene item of a description in one native
+    // call. Source names have to be unique, scenes find their items by name.
+    loadScene(description: SceneDescription | string): LoadedScene {
+        const json = typeof description === "string" ? description : JSON.stringify(description)
+        const handles = obsInstance.Studio.loadScene(json)
+        const loaded: LoadedScene = {sources: {}, scenes: {}}
+
+        for (const name in handles.sources) {
+            loaded.sources[name] = new Source(handles.sources[name], name)
+        }
+        for (const name in handles.scenes) {
+            loaded.scenes[name] = new Scene(name, handles.scenes[name])
+        }
+        return loaded
+    },
+
+    // Save a scene with every source it shows, nested scenes included, as a
+    // JSON scene description loadScene accepts.
+    saveScene(scene: Scene): string {
+        return obsInstance.Studio.saveScene(scene)
+    },
+
+    // Remove the source assigned to an output channel with assignOutputChannel.
+    clearOutputChannel(channel: number): void {
+        obsInstance.Studio.clearOutputChannel(channel)
+    },
+}
 export const VideoEncoder = obsInstance.VideoEncoder
+export const View = obsInstance.View